@@ -3,6 +3,8 @@
 
 #include "Chunk.h"
 
+#include "ChunkCollisionComponent.h"
+#include "ChunkMeshBufferPool.h"
 #include "ChunkRegistry.h"
 #include "LogChunk.h"
 #include "ChunkStats.h"
@@ -17,7 +19,119 @@
 #include "DynamicMesh/DynamicMesh3.h"
 #include "DynamicMesh/MeshNormals.h"
 #include "Bluevox/Data/InstanceTypeDataAsset.h"
+#include "Async/ParallelFor.h"
 #include "Engine/AssetManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "ProceduralMeshComponent.h"
+
+namespace
+{
+	// Rough cost of a FDynamicMesh3 element with the UV and normal overlays BeginRender sets up
+	SIZE_T GetDynamicMeshAllocatedSize(const UE::Geometry::FDynamicMesh3& Mesh)
+	{
+		constexpr SIZE_T BytesPerVertex = 64;
+		constexpr SIZE_T BytesPerTriangle = 96;
+
+		return Mesh.MaxVertexID() * BytesPerVertex + Mesh.MaxTriangleID() * BytesPerTriangle;
+	}
+
+	// Faces collected over a section, merged by the greedy pass once all its columns are walked
+	struct FGreedyCap
+	{
+		int32 LocalX;
+		int32 LocalY;
+		int32 Z;
+		EMaterial MaterialId;
+		bool bTop;
+
+		bool IsCoplanar(const FGreedyCap& Other) const
+		{
+			return bTop == Other.bTop && Z == Other.Z && MaterialId == Other.MaterialId;
+		}
+	};
+
+	struct FGreedySide
+	{
+		EFace Face;
+		// X for North/South, Y for East/West
+		int32 Plane;
+		// The other horizontal coordinate, the one consecutive spans are merged along
+		int32 Along;
+		int32 Z0;
+		int32 Z1;
+		EMaterial MaterialId;
+
+		bool IsSameSpan(const FGreedySide& Other) const
+		{
+			return Face == Other.Face && Plane == Other.Plane && Z0 == Other.Z0 && Z1 == Other.Z1 && MaterialId == Other.MaterialId;
+		}
+	};
+
+	float GetTextureIndex(const EMaterial MaterialId)
+	{
+		return static_cast<float>(static_cast<uint8>(MaterialId));
+	}
+
+	// Top of the highest solid piece of a column and its material, 0 and Void for an empty column
+	void GetColumnSurface(const FChunkColumnView& Column, int32& OutHeight, EMaterial& OutMaterialId)
+	{
+		OutHeight = 0;
+		OutMaterialId = EMaterial::Void;
+
+		int32 Z = 0;
+		for (const FPiece Piece : Column)
+		{
+			Z += Piece.Size;
+			if (Piece.MaterialId != EMaterial::Void)
+			{
+				OutHeight = Z;
+				OutMaterialId = Piece.MaterialId;
+			}
+		}
+	}
+
+	// Representative column of a LOD cell: the highest surface in it, with the most common surface material
+	void GetLodCell(const FRenderColumnWindow& Window, const int32 CellX, const int32 CellY, const FIntPoint& CellSize,
+	                int32& OutHeight, EMaterial& OutMaterialId)
+	{
+		TArray<TPair<EMaterial, int32>, TInlineAllocator<8>> Counts;
+		OutHeight = 0;
+		for (int32 X = CellX; X < CellX + CellSize.X; ++X)
+		{
+			for (int32 Y = CellY; Y < CellY + CellSize.Y; ++Y)
+			{
+				int32 Height;
+				EMaterial MaterialId;
+				GetColumnSurface(Window.Columns[Window.GetIndex(X, Y)], Height, MaterialId);
+				if (MaterialId == EMaterial::Void)
+				{
+					continue;
+				}
+
+				OutHeight = FMath::Max(OutHeight, Height);
+				if (TPair<EMaterial, int32>* Count = Counts.FindByPredicate([MaterialId](const TPair<EMaterial, int32>& Pair) { return Pair.Key == MaterialId; }))
+				{
+					Count->Value++;
+				}
+				else
+				{
+					Counts.Emplace(MaterialId, 1);
+				}
+			}
+		}
+
+		OutMaterialId = EMaterial::Void;
+		int32 BestCount = 0;
+		for (const TPair<EMaterial, int32>& Count : Counts)
+		{
+			if (Count.Value > BestCount)
+			{
+				BestCount = Count.Value;
+				OutMaterialId = Count.Key;
+			}
+		}
+	}
+}
 
 void AChunk::BeginDestroy()
 {
@@ -29,31 +143,124 @@ void AChunk::BeginDestroy()
 	Super::BeginDestroy();
 }
 
+FRenderColumnWindow::FRenderColumnWindow(const FRenderSnapshots& Snapshots)
+{
+	const int32 Size = GameConstants::Chunk::Size;
+	Stride = Size + 2;
+	Columns.SetNum(Stride * Stride);
+
+	for (int32 Y = 0; Y < Size; ++Y)
+	{
+		for (int32 X = 0; X < Size; ++X)
+		{
+			Columns[GetIndex(X, Y)] = Snapshots.Center.GetColumn(FChunkData::GetIndex(X, Y));
+		}
+	}
+
+	// The ring: the first row or column of each neighbor on the side touching this chunk
+	for (const EFace Face : FaceUtils::AllHorizontalFaces)
+	{
+		const FIntVector2 Offset = FaceUtils::GetHorizontalOffsetByFace(Face);
+		const FChunkSnapshot& Neighbor = Snapshots.Neighbors[static_cast<uint8>(Face)];
+		for (int32 Along = 0; Along < Size; ++Along)
+		{
+			const int32 X = Offset.X != 0 ? (Offset.X > 0 ? Size : -1) : Along;
+			const int32 Y = Offset.Y != 0 ? (Offset.Y > 0 ? Size : -1) : Along;
+			Columns[GetIndex(X, Y)] = Neighbor.GetColumn(FChunkData::GetIndex((X + Size) % Size, (Y + Size) % Size));
+		}
+	}
+}
+
+int32 FRenderColumnWindow::GetFaceOffset(const EFace Face) const
+{
+	const FIntVector2 Offset = FaceUtils::GetHorizontalOffsetByFace(Face);
+	return Offset.X + Offset.Y * Stride;
+}
+
 // Sets default values
 AChunk::AChunk()
 {
 	PrimaryActorTick.bCanEverTick = false;
 
-	MeshComponent = CreateDefaultSubobject<UDynamicMeshComponent>(TEXT("MeshComponent"));
-	MeshComponent->bEnableComplexCollision = true;
-	MeshComponent->bCastShadowAsTwoSided = true;
-	MeshComponent->CollisionType = CTF_UseComplexAsSimple;
-	MeshComponent->bUseAsyncCooking = true;
-	MeshComponent->SetMobility(EComponentMobility::Type::Static);
-	MeshComponent->SetGenerateOverlapEvents(false);
-	MeshComponent->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+	RootComponent->SetMobility(EComponentMobility::Type::Static);
+}
 
-	RootComponent = MeshComponent;
+UPrimitiveComponent* AChunk::GetOrCreateSectionComponent(const int32 SectionIndex, const EChunkMeshOutput Output)
+{
+	if (UPrimitiveComponent* Existing = SectionComponents[SectionIndex])
+	{
+		const bool bMatches = Output == EChunkMeshOutput::Collision ? Existing->IsA<UChunkCollisionComponent>()
+			: Output == EChunkMeshOutput::RawStream ? Existing->IsA<UProceduralMeshComponent>()
+			: Existing->IsA<UDynamicMeshComponent>();
+		if (bMatches)
+		{
+			return Existing;
+		}
+
+		Existing->DestroyComponent();
+		SectionComponents[SectionIndex] = nullptr;
+	}
+
+	if (Output == EChunkMeshOutput::Collision)
+	{
+		UChunkCollisionComponent* CollisionComponent = NewObject<UChunkCollisionComponent>(this);
+		CollisionComponent->SetMobility(EComponentMobility::Type::Static);
+		CollisionComponent->SetGenerateOverlapEvents(false);
+		CollisionComponent->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+		CollisionComponent->SetupAttachment(RootComponent);
+		CollisionComponent->RegisterComponent();
+
+		SectionComponents[SectionIndex] = CollisionComponent;
+		return CollisionComponent;
+	}
+
+	UMeshComponent* SectionComponent;
+	if (Output == EChunkMeshOutput::RawStream)
+	{
+		UProceduralMeshComponent* ProceduralComponent = NewObject<UProceduralMeshComponent>(this);
+		ProceduralComponent->bUseComplexAsSimpleCollision = true;
+		ProceduralComponent->bUseAsyncCooking = true;
+		SectionComponent = ProceduralComponent;
+	}
+	else
+	{
+		UDynamicMeshComponent* DynamicComponent = NewObject<UDynamicMeshComponent>(this);
+		DynamicComponent->bEnableComplexCollision = true;
+		DynamicComponent->CollisionType = CTF_UseComplexAsSimple;
+		DynamicComponent->bUseAsyncCooking = true;
+		SectionComponent = DynamicComponent;
+	}
+	SectionComponent->bCastShadowAsTwoSided = true;
+	SectionComponent->SetMobility(EComponentMobility::Type::Static);
+	SectionComponent->SetGenerateOverlapEvents(false);
+	SectionComponent->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+	SectionComponent->SetMaterial(0, GameManager->ChunkMaterial);
+	SectionComponent->SetMaterial(1, GameManager->ChunkMaterialTransparent);
+	SectionComponent->SetVisibility(bSectionsVisible);
+	SectionComponent->SetupAttachment(RootComponent);
+	SectionComponent->RegisterComponent();
+
+	SectionComponents[SectionIndex] = SectionComponent;
+	return SectionComponent;
 }
 
 // TODO also pass render state, so know if should tick or not (in case of live x lod chunks)
 AChunk* AChunk::Init(const FChunkPosition InPosition, AGameManager* InGameManager,
-	UChunkData* InData)
+	FChunkData* InData)
 {
 	Position = InPosition;
 	GameManager = InGameManager;
 	ChunkData = InData;
 
+	// Nothing was emitted yet, the first render builds every section
+	const int32 NumSections = GetNumSections();
+	SectionComponents.SetNumZeroed(NumSections);
+	DirtySections.Init(true, NumSections);
+	SectionRenderIds.Init(INDEX_NONE, NumSections);
+	SectionQuads.Init(INDEX_NONE, NumSections);
+	SectionTranslucentQuads.Init(0, NumSections);
+
 	return this;
 }
 
@@ -228,11 +435,33 @@ void AChunk::InitialSpawnInstancesFromEntities()
 	UE_LOG(LogChunk, Log, TEXT("[InstanceSpawn] Finished spawning instances for chunk %s"), *Position.ToString());
 }
 
-void AChunk::SetRenderState(const EChunkState State) const
+void AChunk::SetRenderState(const EChunkState State)
 {
 	UE_LOG(LogChunk, Verbose, TEXT("SetRenderState for chunk %s to %s"), *Position.ToString(), *UEnum::GetValueAsString(State));
 	const auto Visible = EnumHasAllFlags(State, EChunkState::Visible);
-	MeshComponent->SetVisibility(Visible);
+
+	// Sections are rebuilt with the output matching the new visibility, collision only or full meshes
+	if (Visible != bSectionsVisible)
+	{
+		DirtySections.SetRange(0, DirtySections.Num(), true);
+	}
+	bSectionsVisible = Visible;
+
+	// The current meshes stay up until the ones at the new LOD are committed
+	const int32 Lod = ChunkStateUtils::GetLod(State);
+	if (Lod != RenderLod)
+	{
+		RenderLod = Lod;
+		DirtySections.SetRange(0, DirtySections.Num(), true);
+	}
+
+	for (UPrimitiveComponent* SectionComponent : SectionComponents)
+	{
+		if (SectionComponent)
+		{
+			SectionComponent->SetVisibility(Visible);
+		}
+	}
 
 	// Update instance visibility
 	for (const auto& Pair : ChunkInstanceComponents)
@@ -247,33 +476,97 @@ void AChunk::SetRenderState(const EChunkState State) const
 	// MeshComponent->SetCollisionEnabled(Collision ? ECollisionEnabled::QueryAndPhysics : ECollisionEnabled::NoCollision);
 }
 
-bool AChunk::BeginRender(UE::Geometry::FDynamicMesh3& OutMesh, bool bForceRender)
+void AChunk::PrepareRender(const int32 RenderId, const bool bFullRender, TBitArray<>& OutSections, FSectionQuadHints& OutQuadHints)
+{
+	const int32 Size = GameConstants::Chunk::Size;
+
+	TBitArray<> DirtyColumns;
+	ChunkData->Th_TakeDirtyColumns(DirtyColumns);
+
+	auto MarkColumn = [this, Size](const int32 X, const int32 Y)
+	{
+		if (X >= 0 && X < Size && Y >= 0 && Y < Size)
+		{
+			DirtySections[GetSectionIndex(X, Y)] = true;
+		}
+	};
+
+	for (TConstSetBitIterator<> It(DirtyColumns); It; ++It)
+	{
+		const int32 X = It.GetIndex() % Size;
+		const int32 Y = It.GetIndex() / Size;
+		MarkColumn(X, Y);
+
+		// The side faces of the columns around depend on it too, and they may sit in another section
+		for (const EFace Face : FaceUtils::AllHorizontalFaces)
+		{
+			const FIntVector2 Offset = FaceUtils::GetHorizontalOffsetByFace(Face);
+			MarkColumn(X + Offset.X, Y + Offset.Y);
+		}
+	}
+
+	if (bFullRender)
+	{
+		DirtySections.SetRange(0, DirtySections.Num(), true);
+	}
+
+	OutSections = DirtySections;
+	for (TConstSetBitIterator<> It(OutSections); It; ++It)
+	{
+		SectionRenderIds[It.GetIndex()] = RenderId;
+	}
+
+	OutQuadHints = GetSectionQuadHints();
+}
+
+bool AChunk::BeginRender(FRenderResult& OutResult, const FRenderColumnWindow& Window, const TBitArray<>& Sections,
+	const FSectionQuadHints& QuadHints, const EChunkMeshOutput Output, const int32 Lod, const bool bPriority)
 {
  SCOPE_CYCLE_COUNTER(STAT_Chunk_BeginRender);
 	UE_LOG(LogChunk, Verbose, TEXT("Th_BeginRender for chunk %s"), *Position.ToString());
 
 	const uint64 Start = FPlatformTime::Cycles64();
 
-	if (!bForceRender && RenderedAtDirtyChanges.GetValue() == ChunkData->Changes)
+	if (Sections.Find(true) == INDEX_NONE)
 	{
 		return false;
 	}
 
- // Reset and prepare mesh attributes
-	OutMesh.Clear();
-	OutMesh.EnableAttributes();
-	OutMesh.Attributes()->SetNumUVLayers(2);
-	OutMesh.Attributes()->SetNumNormalLayers(1);
+	OutResult.Output = Output;
+	for (TConstSetBitIterator<> It(Sections); It; ++It)
+	{
+		OutResult.Sections.AddDefaulted_GetRef().Index = It.GetIndex();
+	}
 
-	using namespace UE::Geometry;
-	FDynamicMeshUVOverlay* UV0 = OutMesh.Attributes()->PrimaryUV();
-	FDynamicMeshUVOverlay* UV1 = OutMesh.Attributes()->GetUVLayer(1);
-	FDynamicMeshNormalOverlay* NO = OutMesh.Attributes()->PrimaryNormals();
+	// Sections only share the snapshots, each one is built into its own buffers. Other chunks keep the rest of the
+	// workers busy, only the chunk under a player spreads over all of them
+	ParallelFor(OutResult.Sections.Num(), [this, &OutResult, &Window, &QuadHints, Output, Lod](const int32 Index)
+	{
+		BuildSection(OutResult.Sections[Index], Window, QuadHints, Output, Lod);
+	}, bPriority ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
 
-	const auto ChunkRegistry = GameManager->ChunkRegistry;
+	const uint64 End = FPlatformTime::Cycles64();
+	UE_LOG(LogChunk, Verbose, TEXT("Chunk %s rendered in %f ms"), *Position.ToString(), FPlatformTime::ToMilliseconds64(End - Start));
+
+	return true;
+}
+
+void AChunk::BuildSection(FRenderSection& Section, const FRenderColumnWindow& Window, const FSectionQuadHints& QuadHints,
+	const EChunkMeshOutput Output, const int32 Lod) const
+{
+	// Section being emitted, the lambdas below append to the stream or to the mesh depending on Output
+	using namespace UE::Geometry;
+	FChunkMeshStream* OutStream = nullptr;
+	FChunkMeshStream* OutTranslucentStream = nullptr;
+	FChunkCollisionStream* OutCollision = nullptr;
+	FDynamicMesh3* OutMesh = nullptr;
+	FDynamicMeshUVOverlay* UV0 = nullptr;
+	FDynamicMeshUVOverlay* UV1 = nullptr;
+	FDynamicMeshNormalOverlay* NO = nullptr;
+	FDynamicMeshMaterialAttribute* MaterialIDs = nullptr;
 
  // Lambda to add a quad (two triangles) with UVs and per-face normals (UV0 = texcoords, UV1.x = texture array index)
-	auto AddQuad = [&](FVector3d V0, FVector3d V1, FVector3d V2, FVector3d V3,
+	auto AddQuad = [&](const bool bTranslucent, FVector3d V0, FVector3d V1, FVector3d V2, FVector3d V3,
 		FVector2f T0_UV0, FVector2f T1_UV0, FVector2f T2_UV0, FVector2f T3_UV0,
 		float TextureIndex, const FVector3f& DesiredNormal)
 	{
@@ -289,13 +582,32 @@ bool AChunk::BeginRender(UE::Geometry::FDynamicMesh3& OutMesh, bool bForceRender
 			// Recompute normal (optional)
 		}
 
-		const int32 I0 = OutMesh.AppendVertex(V0);
-		const int32 I1 = OutMesh.AppendVertex(V1);
-		const int32 I2 = OutMesh.AppendVertex(V2);
-		const int32 I3 = OutMesh.AppendVertex(V3);
+		if (OutCollision)
+		{
+			OutCollision->AddQuad(FVector3f(V0), FVector3f(V1), FVector3f(V2), FVector3f(V3));
+			return;
+		}
+
+		if (OutStream)
+		{
+			(bTranslucent ? OutTranslucentStream : OutStream)->AddQuad(FVector3f(V0), FVector3f(V1), FVector3f(V2), FVector3f(V3),
+				T0_UV0, T1_UV0, T2_UV0, T3_UV0, TextureIndex, DesiredNormal.GetSafeNormal());
+			return;
+		}
+
+		const int32 I0 = OutMesh->AppendVertex(V0);
+		const int32 I1 = OutMesh->AppendVertex(V1);
+		const int32 I2 = OutMesh->AppendVertex(V2);
+		const int32 I3 = OutMesh->AppendVertex(V3);
 
-		const int32 Tri0 = OutMesh.AppendTriangle(I0, I1, I2);
-		const int32 Tri1 = OutMesh.AppendTriangle(I0, I2, I3);
+		const int32 Tri0 = OutMesh->AppendTriangle(I0, I1, I2);
+		const int32 Tri1 = OutMesh->AppendTriangle(I0, I2, I3);
+
+		if (MaterialIDs)
+		{
+			MaterialIDs->SetValue(Tri0, bTranslucent ? 1 : 0);
+			MaterialIDs->SetValue(Tri1, bTranslucent ? 1 : 0);
+		}
 
 		if (UV0)
 		{
@@ -335,18 +647,30 @@ bool AChunk::BeginRender(UE::Geometry::FDynamicMesh3& OutMesh, bool bForceRender
 	const float SZ = GameConstants::Scaling::ZWorldSize;
 
 	// Precompute base world column position
-	FColumnPosition GlobalPos;
 	const int32 BaseChunkPosX = Position.X * GameConstants::Chunk::Size;
 	const int32 BaseChunkPosY = Position.Y * GameConstants::Chunk::Size;
 
 	TStaticArray<FRenderNeighbor, 4> Neighbors;
 
-	auto EmitSideSpan = [&](EFace Face, int32 LocalX, int32 LocalY, int32 Z0, int32 Z1, float TexIndex)
+	TStaticArray<int32, 4> FaceOffsets;
+	for (const EFace Face : FaceUtils::AllHorizontalFaces)
 	{
+		FaceOffsets[static_cast<uint8>(Face)] = Window.GetFaceOffset(Face);
+	}
+
+	// Side quad spanning Run columns from LocalX/LocalY, along Y for North/South and along X for East/West
+	auto EmitSideSpan = [&](EFace Face, int32 LocalX, int32 LocalY, int32 Run, int32 Z0, int32 Z1, EMaterial MaterialId)
+	{
+		const float TexIndex = GetTextureIndex(MaterialId);
+		const bool bTranslucent = MaterialUtils::IsTranslucent(MaterialId);
+		const bool bAlongY = Face == EFace::North || Face == EFace::South;
+		const int32 RunX = bAlongY ? 1 : Run;
+		const int32 RunY = bAlongY ? Run : 1;
+
 		const double x0 = LocalX * SXY;
-		const double x1 = (LocalX + 1) * SXY;
+		const double x1 = (LocalX + RunX) * SXY;
 		const double y0w = LocalY * SXY;
-		const double y1w = (LocalY + 1) * SXY;
+		const double y1w = (LocalY + RunY) * SXY;
 		const double z0w = Z0 * SZ;
 		const double z1w = Z1 * SZ;
 
@@ -361,10 +685,10 @@ bool AChunk::BeginRender(UE::Geometry::FDynamicMesh3& OutMesh, bool bForceRender
 		case EFace::North: // +X, plane at x1
 		{
 			const float u0 = (GlobalYInt) * TileXYPerBlock;
-			const float u1 = (GlobalYInt + 1) * TileXYPerBlock;
+			const float u1 = (GlobalYInt + RunY) * TileXYPerBlock;
 			const float v0 = Z0 * TilePerLayerZ;
 			const float v1 = Z1 * TilePerLayerZ;
-   AddQuad(
+   AddQuad(bTranslucent,
 				FVector3d(x1, y0w, z0w), FVector3d(x1, y1w, z0w), FVector3d(x1, y1w, z1w), FVector3d(x1, y0w, z1w),
 				FVector2f(u0, v0), FVector2f(u1, v0), FVector2f(u1, v1), FVector2f(u0, v1),
 				TexIndex, FVector3f(1, 0, 0));
@@ -373,10 +697,10 @@ bool AChunk::BeginRender(UE::Geometry::FDynamicMesh3& OutMesh, bool bForceRender
 		case EFace::South: // -X, plane at x0
 		{
 			const float u0 = (GlobalYInt) * TileXYPerBlock;
-			const float u1 = (GlobalYInt + 1) * TileXYPerBlock;
+			const float u1 = (GlobalYInt + RunY) * TileXYPerBlock;
 			const float v0 = Z0 * TilePerLayerZ;
 			const float v1 = Z1 * TilePerLayerZ;
-   AddQuad(
+   AddQuad(bTranslucent,
 				FVector3d(x0, y1w, z0w), FVector3d(x0, y0w, z0w), FVector3d(x0, y0w, z1w), FVector3d(x0, y1w, z1w),
 				FVector2f(u1, v0), FVector2f(u0, v0), FVector2f(u0, v1), FVector2f(u1, v1),
 				TexIndex, FVector3f(-1, 0, 0));
@@ -385,10 +709,10 @@ bool AChunk::BeginRender(UE::Geometry::FDynamicMesh3& OutMesh, bool bForceRender
 		case EFace::East: // +Y, plane at y1
 		{
 			const float u0 = (GlobalXInt) * TileXYPerBlock;
-			const float u1 = (GlobalXInt + 1) * TileXYPerBlock;
+			const float u1 = (GlobalXInt + RunX) * TileXYPerBlock;
 			const float v0 = Z0 * TilePerLayerZ;
 			const float v1 = Z1 * TilePerLayerZ;
-   AddQuad(
+   AddQuad(bTranslucent,
 				FVector3d(x0, y1w, z0w), FVector3d(x0, y1w, z1w), FVector3d(x1, y1w, z1w), FVector3d(x1, y1w, z0w),
 				FVector2f(u0, v0), FVector2f(u0, v1), FVector2f(u1, v1), FVector2f(u1, v0),
 				TexIndex, FVector3f(0, 1, 0));
@@ -397,10 +721,10 @@ bool AChunk::BeginRender(UE::Geometry::FDynamicMesh3& OutMesh, bool bForceRender
 		case EFace::West: // -Y, plane at y0
 		{
 			const float u0 = (GlobalXInt) * TileXYPerBlock;
-			const float u1 = (GlobalXInt + 1) * TileXYPerBlock;
+			const float u1 = (GlobalXInt + RunX) * TileXYPerBlock;
 			const float v0 = Z0 * TilePerLayerZ;
 			const float v1 = Z1 * TilePerLayerZ;
-   AddQuad(
+   AddQuad(bTranslucent,
 				FVector3d(x0, y0w, z0w), FVector3d(x1, y0w, z0w), FVector3d(x1, y0w, z1w), FVector3d(x0, y0w, z1w),
 				FVector2f(u0, v0), FVector2f(u1, v0), FVector2f(u1, v1), FVector2f(u0, v1),
 				TexIndex, FVector3f(0, -1, 0));
@@ -411,12 +735,15 @@ bool AChunk::BeginRender(UE::Geometry::FDynamicMesh3& OutMesh, bool bForceRender
 		}
 	};
 
-	auto EmitCap = [&](bool bTop, int32 LocalX, int32 LocalY, int32 Z, float TexIndex)
+	// Cap quad covering SizeX x SizeY columns from LocalX/LocalY
+	auto EmitCap = [&](bool bTop, int32 LocalX, int32 LocalY, int32 SizeX, int32 SizeY, int32 Z, EMaterial MaterialId)
 	{
+		const float TexIndex = GetTextureIndex(MaterialId);
+		const bool bTranslucent = MaterialUtils::IsTranslucent(MaterialId);
 		const double x0w = LocalX * SXY;
-		const double x1w = (LocalX + 1) * SXY;
+		const double x1w = (LocalX + SizeX) * SXY;
 		const double y0w = LocalY * SXY;
-		const double y1w = (LocalY + 1) * SXY;
+		const double y1w = (LocalY + SizeY) * SXY;
 		const double zw = Z * SZ;
 
 		const int32 GlobalXInt = BaseChunkPosX + LocalX;
@@ -424,14 +751,14 @@ bool AChunk::BeginRender(UE::Geometry::FDynamicMesh3& OutMesh, bool bForceRender
 		constexpr float TileXYPerBlock = 1.0f;
 
 		const float u0 = (GlobalXInt) * TileXYPerBlock;
-		const float u1 = (GlobalXInt + 1) * TileXYPerBlock;
+		const float u1 = (GlobalXInt + SizeX) * TileXYPerBlock;
 		const float v0 = (GlobalYInt) * TileXYPerBlock;
-		const float v1 = (GlobalYInt + 1) * TileXYPerBlock;
+		const float v1 = (GlobalYInt + SizeY) * TileXYPerBlock;
 
 		if (bTop)
 		{
 			// Top face, normal +Z (CCW when viewed from above)
-   AddQuad(
+   AddQuad(bTranslucent,
 				FVector3d(x0w, y0w, zw), FVector3d(x0w, y1w, zw), FVector3d(x1w, y1w, zw), FVector3d(x1w, y0w, zw),
 				FVector2f(u0, v0), FVector2f(u0, v1), FVector2f(u1, v1), FVector2f(u1, v0),
 				TexIndex, FVector3f(0, 0, 1));
@@ -439,45 +766,313 @@ bool AChunk::BeginRender(UE::Geometry::FDynamicMesh3& OutMesh, bool bForceRender
 		else
 		{
 			// Bottom face, normal -Z (CCW when viewed from below)
-   AddQuad(
+   AddQuad(bTranslucent,
 				FVector3d(x1w, y0w, zw), FVector3d(x1w, y1w, zw), FVector3d(x0w, y1w, zw), FVector3d(x0w, y0w, zw),
 				FVector2f(u1, v0), FVector2f(u1, v1), FVector2f(u0, v1), FVector2f(u0, v0),
 				TexIndex, FVector3f(0, 0, -1));
 		}
 	};
 
-	for (int32 LocalX = 0; LocalX < GameConstants::Chunk::Size; ++LocalX)
+	const bool bGreedy = GameConstants::Chunk::Render::bGreedyMeshing;
+	TArray<FGreedyCap> Caps;
+	TArray<FGreedySide> Sides;
+	TArray<bool> CapMask;
+
+	auto AddSide = [&](EFace Face, int32 LocalX, int32 LocalY, int32 Z0, int32 Z1, EMaterial MaterialId)
+	{
+		if (!bGreedy)
+		{
+			EmitSideSpan(Face, LocalX, LocalY, 1, Z0, Z1, MaterialId);
+			return;
+		}
+
+		const bool bAlongY = Face == EFace::North || Face == EFace::South;
+		Sides.Add(FGreedySide{Face, bAlongY ? LocalX : LocalY, bAlongY ? LocalY : LocalX, Z0, Z1, MaterialId});
+	};
+
+	auto AddCap = [&](bool bTop, int32 LocalX, int32 LocalY, int32 Z, EMaterial MaterialId)
+	{
+		if (!bGreedy)
+		{
+			EmitCap(bTop, LocalX, LocalY, 1, 1, Z, MaterialId);
+			return;
+		}
+
+		Caps.Add(FGreedyCap{LocalX, LocalY, Z, MaterialId, bTop});
+	};
+
+	// Emits the faces collected over the section at MinX/MinY as maximal rectangles
+	auto EmitGreedyFaces = [&](const int32 MinX, const int32 MinY, const int32 SizeX, const int32 SizeY)
+	{
+		// Identical spans of consecutive columns facing the same way become a single quad
+		Sides.Sort([](const FGreedySide& A, const FGreedySide& B)
+		{
+			if (A.Face != B.Face) return A.Face < B.Face;
+			if (A.Plane != B.Plane) return A.Plane < B.Plane;
+			if (A.Z0 != B.Z0) return A.Z0 < B.Z0;
+			if (A.Z1 != B.Z1) return A.Z1 < B.Z1;
+			if (A.MaterialId != B.MaterialId) return A.MaterialId < B.MaterialId;
+			return A.Along < B.Along;
+		});
+
+		for (int32 First = 0; First < Sides.Num();)
+		{
+			const FGreedySide& Side = Sides[First];
+			int32 Last = First;
+			while (Last + 1 < Sides.Num() && Sides[Last + 1].IsSameSpan(Side) && Sides[Last + 1].Along == Sides[Last].Along + 1)
+			{
+				++Last;
+			}
+
+			const bool bAlongY = Side.Face == EFace::North || Side.Face == EFace::South;
+			EmitSideSpan(Side.Face, bAlongY ? Side.Plane : Side.Along, bAlongY ? Side.Along : Side.Plane, Last - First + 1,
+				Side.Z0, Side.Z1, Side.MaterialId);
+			First = Last + 1;
+		}
+		Sides.Reset();
+
+		// Caps on the same plane with the same material are merged over a mask of the section, row first
+		Caps.Sort([](const FGreedyCap& A, const FGreedyCap& B)
+		{
+			if (A.bTop != B.bTop) return A.bTop < B.bTop;
+			if (A.Z != B.Z) return A.Z < B.Z;
+			return A.MaterialId < B.MaterialId;
+		});
+
+		for (int32 First = 0; First < Caps.Num();)
+		{
+			const FGreedyCap& Cap = Caps[First];
+			int32 End = First;
+			CapMask.Init(false, SizeX * SizeY);
+			while (End < Caps.Num() && Caps[End].IsCoplanar(Cap))
+			{
+				CapMask[Caps[End].LocalX - MinX + (Caps[End].LocalY - MinY) * SizeX] = true;
+				++End;
+			}
+
+			for (int32 Y = 0; Y < SizeY; ++Y)
+			{
+				for (int32 X = 0; X < SizeX; ++X)
+				{
+					if (!CapMask[X + Y * SizeX])
+					{
+						continue;
+					}
+
+					int32 Width = 1;
+					while (X + Width < SizeX && CapMask[X + Width + Y * SizeX])
+					{
+						++Width;
+					}
+
+					int32 Height = 1;
+					for (bool bRowFilled = true; bRowFilled && Y + Height < SizeY; )
+					{
+						for (int32 RowX = X; RowX < X + Width; ++RowX)
+						{
+							bRowFilled &= CapMask[RowX + (Y + Height) * SizeX];
+						}
+						Height += bRowFilled ? 1 : 0;
+					}
+
+					for (int32 RectY = Y; RectY < Y + Height; ++RectY)
+					{
+						for (int32 RectX = X; RectX < X + Width; ++RectX)
+						{
+							CapMask[RectX + RectY * SizeX] = false;
+						}
+					}
+
+					EmitCap(Cap.bTop, MinX + X, MinY + Y, Width, Height, Cap.Z, Cap.MaterialId);
+				}
+			}
+
+			First = End;
+		}
+		Caps.Reset();
+	};
+
+	const int32 SectionSize = GameConstants::Chunk::Render::SectionSize;
+	const int32 NumSectionsPerSide = GetNumSectionsPerSide();
+
+	const int32 MinX = Section.Index % NumSectionsPerSide * SectionSize;
+	const int32 MinY = Section.Index / NumSectionsPerSide * SectionSize;
+	const int32 MaxX = FMath::Min(MinX + SectionSize, GameConstants::Chunk::Size);
+	const int32 MaxY = FMath::Min(MinY + SectionSize, GameConstants::Chunk::Size);
+
+	if (Output != EChunkMeshOutput::DynamicMesh)
+	{
+		// Sized from the last commit of the section with some headroom for edits. A section never committed takes
+		// the bound of 4 sides and 2 caps per solid piece, its buffers never grow while emitting
+		int32 MaxQuads = QuadHints.Quads[Section.Index];
+		int32 MaxTranslucentQuads = QuadHints.TranslucentQuads[Section.Index];
+		if (MaxQuads != INDEX_NONE)
+		{
+			MaxQuads += MaxQuads / 4;
+			MaxTranslucentQuads += MaxTranslucentQuads / 4;
+		}
+		else
+		{
+			MaxQuads = 0;
+			MaxTranslucentQuads = 0;
+			for (int32 LocalX = MinX; LocalX < MaxX; ++LocalX)
+			{
+				for (int32 LocalY = MinY; LocalY < MaxY; ++LocalY)
+				{
+					for (const FPiece Piece : Window.Columns[Window.GetIndex(LocalX, LocalY)])
+					{
+						if (Piece.MaterialId != EMaterial::Void)
+						{
+							const bool bTranslucent = Output != EChunkMeshOutput::Collision && MaterialUtils::IsTranslucent(Piece.MaterialId);
+							(bTranslucent ? MaxTranslucentQuads : MaxQuads) += 6;
+						}
+					}
+				}
+			}
+		}
+
+		if (Output == EChunkMeshOutput::Collision)
+		{
+			OutCollision = &Section.Collision;
+			FChunkMeshBufferPool::Acquire(*OutCollision, MaxQuads + MaxTranslucentQuads);
+		}
+		else
+		{
+			OutStream = &Section.Stream;
+			FChunkMeshBufferPool::Acquire(*OutStream, MaxQuads);
+
+			OutTranslucentStream = &Section.TranslucentStream;
+			FChunkMeshBufferPool::Acquire(*OutTranslucentStream, MaxTranslucentQuads);
+		}
+	}
+	else
+	{
+		// Reset and prepare mesh attributes
+		OutMesh = &Section.Mesh;
+		OutMesh->EnableAttributes();
+		OutMesh->Attributes()->SetNumUVLayers(2);
+		OutMesh->Attributes()->SetNumNormalLayers(1);
+		UV0 = OutMesh->Attributes()->PrimaryUV();
+		UV1 = OutMesh->Attributes()->GetUVLayer(1);
+		NO = OutMesh->Attributes()->PrimaryNormals();
+		OutMesh->Attributes()->EnableMaterialID();
+		MaterialIDs = OutMesh->Attributes()->GetMaterialID();
+	}
+
+	// Columns merged per side of a LOD cell, cells never straddle sections
+	int32 Step = 1 << Lod;
+	while (Step > 1 && SectionSize % Step != 0)
+	{
+		Step >>= 1;
+	}
+
+	if (Step > 1)
+	{
+		const int32 Size = GameConstants::Chunk::Size;
+		for (int32 CellX = MinX; CellX < MaxX; CellX += Step)
+		{
+			for (int32 CellY = MinY; CellY < MaxY; CellY += Step)
+			{
+				const FIntPoint CellSize(FMath::Min(Step, MaxX - CellX), FMath::Min(Step, MaxY - CellY));
+				int32 Height;
+				EMaterial MaterialId;
+				GetLodCell(Window, CellX, CellY, CellSize, Height, MaterialId);
+				if (MaterialId == EMaterial::Void)
+				{
+					continue;
+				}
+
+				for (int32 X = CellX; X < CellX + CellSize.X; ++X)
+				{
+					for (int32 Y = CellY; Y < CellY + CellSize.Y; ++Y)
+					{
+						AddCap(true, X, Y, Height, MaterialId);
+					}
+				}
+
+				for (const EFace Face : FaceUtils::AllHorizontalFaces)
+				{
+					const FIntVector2 Offset = FaceUtils::GetHorizontalOffsetByFace(Face);
+
+					// Columns of the cell on this side
+					const int32 EdgeMinX = Offset.X > 0 ? CellX + CellSize.X - 1 : CellX;
+					const int32 EdgeMaxX = Offset.X < 0 ? CellX : CellX + CellSize.X - 1;
+					const int32 EdgeMinY = Offset.Y > 0 ? CellY + CellSize.Y - 1 : CellY;
+					const int32 EdgeMaxY = Offset.Y < 0 ? CellY : CellY + CellSize.Y - 1;
+
+					// Walls go down to the next cell inside the chunk. Across the border they go down to the lowest
+					// real column of the neighbor, so there's no gap whatever LOD the neighbor is meshed at
+					int32 Floor;
+					const FIntPoint NextCell(CellX + Offset.X * Step, CellY + Offset.Y * Step);
+					if (NextCell.X >= 0 && NextCell.X < Size && NextCell.Y >= 0 && NextCell.Y < Size)
+					{
+						EMaterial NextMaterialId;
+						GetLodCell(Window, NextCell.X, NextCell.Y,
+							FIntPoint(FMath::Min(Step, Size - NextCell.X), FMath::Min(Step, Size - NextCell.Y)), Floor, NextMaterialId);
+					}
+					else
+					{
+						Floor = Height;
+						for (int32 X = EdgeMinX; X <= EdgeMaxX; ++X)
+						{
+							for (int32 Y = EdgeMinY; Y <= EdgeMaxY; ++Y)
+							{
+								int32 NeighborHeight;
+								EMaterial NeighborMaterialId;
+								GetColumnSurface(Window.Columns[Window.GetIndex(X + Offset.X, Y + Offset.Y)], NeighborHeight, NeighborMaterialId);
+								Floor = FMath::Min(Floor, NeighborHeight);
+							}
+						}
+					}
+
+					if (Floor >= Height)
+					{
+						continue;
+					}
+
+					for (int32 X = EdgeMinX; X <= EdgeMaxX; ++X)
+					{
+						for (int32 Y = EdgeMinY; Y <= EdgeMaxY; ++Y)
+						{
+							AddSide(Face, X, Y, Floor, Height, MaterialId);
+						}
+					}
+				}
+			}
+		}
+
+		EmitGreedyFaces(MinX, MinY, MaxX - MinX, MaxY - MinY);
+		return;
+	}
+
+	const int32 WaterViewDepth = FMath::Max(GameConstants::Chunk::Render::WaterViewDepth, 0);
+	for (int32 LocalX = MinX; LocalX < MaxX; ++LocalX)
 	{
-		for (int32 LocalY = 0; LocalY < GameConstants::Chunk::Size; ++LocalY)
+		for (int32 LocalY = MinY; LocalY < MaxY; ++LocalY)
 		{
 			SCOPE_CYCLE_COUNTER(STAT_Chunk_BeginRender_ProcessColumn);
 
-			const int32 ColumnIndex = UChunkData::GetIndex(LocalX, LocalY);
-			const TArray<FPiece>& Pieces = ChunkData->Columns[ColumnIndex].Pieces;
+			const int32 WindowIndex = Window.GetIndex(LocalX, LocalY);
+			const FChunkColumnView& Pieces = Window.Columns[WindowIndex];
 			const int32 PiecesCount = Pieces.Num();
 
-			GlobalPos.X = BaseChunkPosX + LocalX;
-			GlobalPos.Y = BaseChunkPosY + LocalY;
-
 			// Setup neighbor iterators (aligned by Z)
 			for (const EFace Face : FaceUtils::AllHorizontalFaces)
 			{
-				const FChunkColumn& Column = ChunkRegistry->Th_GetColumn(GlobalPos + FaceUtils::GetHorizontalOffsetByFace(Face));
+				const FChunkColumnView& Column = Window.Columns[WindowIndex + FaceOffsets[static_cast<uint8>(Face)]];
 				FRenderNeighbor& Neighbor = Neighbors[static_cast<uint8>(Face)];
-				Neighbor.Column = &Column;
+				Neighbor.Column = Column;
 				Neighbor.Index = 0;
 				Neighbor.Start = 0;
-				Neighbor.Size = Column.Pieces.Num() > 0 ? Column.Pieces[0].Size : 0;
-				Neighbor.Piece = Column.Pieces.Num() > 0 ? &Column.Pieces[0] : nullptr;
-				Neighbor.MaterialId = Neighbor.Piece ? Neighbor.Piece->MaterialId : EMaterial::Void;
+				Neighbor.Size = Column.Num() > 0 ? Column[0].Size : 0;
+				Neighbor.MaterialId = Column.Num() > 0 ? Column[0].MaterialId : EMaterial::Void;
 			}
 
 			int32 CurZ = 0;
 			for (int32 PieceIdx = 0; PieceIdx < PiecesCount; ++PieceIdx)
 			{
-				const FPiece& Piece = Pieces[PieceIdx];
+				const FPiece Piece = Pieces[PieceIdx];
 				const int32 PieceSize = Piece.Size;
-				const float TexIndex = static_cast<float>(static_cast<uint8>(Piece.MaterialId));
 
 				if (Piece.MaterialId == EMaterial::Void)
 				{
@@ -485,20 +1080,23 @@ bool AChunk::BeginRender(UE::Geometry::FDynamicMesh3& OutMesh, bool bForceRender
 					for (const EFace Face : FaceUtils::AllHorizontalFaces)
 					{
 						FRenderNeighbor& N = Neighbors[static_cast<uint8>(Face)];
-						while (N.Index + 1 < N.Column->Pieces.Num() && (CurZ + PieceSize) >= (N.Start + N.Size))
+						while (N.Index + 1 < N.Column.Num() && (CurZ + PieceSize) >= (N.Start + N.Size))
 						{
 							N.Start += N.Size;
 							N.Index += 1;
-							N.Size = N.Column->Pieces[N.Index].Size;
-							N.Piece = &N.Column->Pieces[N.Index];
-							N.MaterialId = N.Piece->MaterialId;
+							N.Size = N.Column[N.Index].Size;
+							N.MaterialId = N.Column[N.Index].MaterialId;
 						}
 					}
 					CurZ += PieceSize;
 					continue;
 				}
 
-				// Emit side faces by greedy merging along Z where neighbor is void
+				// Water still collides as a whole, its collision mesh has no use for what's seen through it
+				const bool bSeesThroughTranslucent = Output != EChunkMeshOutput::Collision
+					&& !MaterialUtils::IsTranslucent(Piece.MaterialId);
+
+				// Emit side faces by greedy merging along Z where neighbor is void, or close below a translucent top
 				for (const EFace Face : FaceUtils::AllHorizontalFaces)
 				{
 					FRenderNeighbor& N = Neighbors[static_cast<uint8>(Face)];
@@ -508,33 +1106,43 @@ bool AChunk::BeginRender(UE::Geometry::FDynamicMesh3& OutMesh, bool bForceRender
 					{
 						const int32 CurrentZ = CurZ + Processed;
 						const int32 NeighborEndZ = N.Start + N.Size;
-						const int32 SpanEndZ = FMath::Min(CurZ + PieceSize, NeighborEndZ);
-						const bool bNeighborIsVoid = (N.MaterialId == EMaterial::Void);
+						int32 SpanEndZ = FMath::Min(CurZ + PieceSize, NeighborEndZ);
 
-						if (bNeighborIsVoid)
+						// Through translucent neighbors only the faces close enough to their top are seen
+						bool bFaceSeen = N.MaterialId == EMaterial::Void;
+						if (bSeesThroughTranslucent && MaterialUtils::IsTranslucent(N.MaterialId))
+						{
+							const int32 SeenFromZ = NeighborEndZ - WaterViewDepth;
+							bFaceSeen = CurrentZ >= SeenFromZ;
+							if (!bFaceSeen)
+							{
+								SpanEndZ = FMath::Min(SpanEndZ, SeenFromZ);
+							}
+						}
+
+						if (bFaceSeen)
 						{
 							if (RunStartZ < 0) RunStartZ = CurrentZ;
 						}
 						else if (RunStartZ >= 0)
 						{
-							EmitSideSpan(Face, LocalX, LocalY, RunStartZ, CurrentZ, TexIndex);
+							AddSide(Face, LocalX, LocalY, RunStartZ, CurrentZ, Piece.MaterialId);
 							RunStartZ = -1;
 						}
 
 						Processed += (SpanEndZ - CurrentZ);
 
-						if (SpanEndZ >= NeighborEndZ && (N.Index + 1) < N.Column->Pieces.Num())
+						if (SpanEndZ >= NeighborEndZ && (N.Index + 1) < N.Column.Num())
 						{
 							N.Start += N.Size;
 							N.Index += 1;
-							N.Size = N.Column->Pieces[N.Index].Size;
-							N.Piece = &N.Column->Pieces[N.Index];
-							N.MaterialId = N.Piece->MaterialId;
+							N.Size = N.Column[N.Index].Size;
+							N.MaterialId = N.Column[N.Index].MaterialId;
 						}
 					}
 					if (RunStartZ >= 0)
 					{
-						EmitSideSpan(Face, LocalX, LocalY, RunStartZ, CurZ + PieceSize, TexIndex);
+						AddSide(Face, LocalX, LocalY, RunStartZ, CurZ + PieceSize, Piece.MaterialId);
 					}
 				}
 
@@ -542,11 +1150,13 @@ bool AChunk::BeginRender(UE::Geometry::FDynamicMesh3& OutMesh, bool bForceRender
 				bool bRenderTop = true;
 				if (PieceIdx < PiecesCount - 1)
 				{
-					bRenderTop = (Pieces[PieceIdx + 1].MaterialId == EMaterial::Void);
+					const FPiece Above = Pieces[PieceIdx + 1];
+					bRenderTop = Above.MaterialId == EMaterial::Void
+						|| (bSeesThroughTranslucent && MaterialUtils::IsTranslucent(Above.MaterialId) && Above.Size <= WaterViewDepth);
 				}
 				if (bRenderTop)
 				{
-					EmitCap(true, LocalX, LocalY, CurZ + PieceSize, TexIndex);
+					AddCap(true, LocalX, LocalY, CurZ + PieceSize, Piece.MaterialId);
 				}
 
 				// Bottom cap: only if there is void below AND not at world Z==0
@@ -561,7 +1171,7 @@ bool AChunk::BeginRender(UE::Geometry::FDynamicMesh3& OutMesh, bool bForceRender
 				}
 				if (bRenderBottom)
 				{
-					EmitCap(false, LocalX, LocalY, CurZ, TexIndex);
+					AddCap(false, LocalX, LocalY, CurZ, Piece.MaterialId);
 				}
 
 				CurZ += PieceSize;
@@ -569,19 +1179,70 @@ bool AChunk::BeginRender(UE::Geometry::FDynamicMesh3& OutMesh, bool bForceRender
 		}
 	}
 
-	RenderedAtDirtyChanges.Set(ChunkData->Changes);
+	EmitGreedyFaces(MinX, MinY, MaxX - MinX, MaxY - MinY);
+}
 
-	const uint64 End = FPlatformTime::Cycles64();
-	UE_LOG(LogChunk, Verbose, TEXT("Chunk %s rendered in %f ms"), *Position.ToString(), FPlatformTime::ToMilliseconds64(End - Start));
+SIZE_T AChunk::GetMeshAllocatedSize() const
+{
+	SIZE_T Bytes = 0;
+	for (UPrimitiveComponent* SectionComponent : SectionComponents)
+	{
+		if (const UChunkCollisionComponent* CollisionComponent = Cast<UChunkCollisionComponent>(SectionComponent))
+		{
+			Bytes += CollisionComponent->GetAllocatedSize();
+		}
+		else if (UProceduralMeshComponent* ProceduralComponent = Cast<UProceduralMeshComponent>(SectionComponent))
+		{
+			for (int32 MeshSection = 0; MeshSection < ProceduralComponent->GetNumSections(); ++MeshSection)
+			{
+				const FProcMeshSection* Section = ProceduralComponent->GetProcMeshSection(MeshSection);
+				Bytes += Section->ProcVertexBuffer.GetAllocatedSize() + Section->ProcIndexBuffer.GetAllocatedSize();
+			}
+		}
+		else if (const UDynamicMeshComponent* DynamicComponent = Cast<UDynamicMeshComponent>(SectionComponent))
+		{
+			Bytes += GetDynamicMeshAllocatedSize(*DynamicComponent->GetMesh());
+		}
+	}
 
-	return true;
+	return Bytes;
 }
 
-void AChunk::CommitRender(FRenderResult&& RenderResult)
+void AChunk::CommitRender(const int32 RenderId, FRenderResult&& RenderResult)
 {
-	UE_LOG(LogChunk, Log, TEXT("[CommitRender] Committing render for chunk %s"), *Position.ToString());
-	MeshComponent->SetMaterial(0, GameManager->ChunkMaterial);
-	MeshComponent->SetMesh(MoveTemp(RenderResult.Mesh));
+	UE_LOG(LogChunk, Log, TEXT("[CommitRender] Committing %d sections for chunk %s"), RenderResult.Sections.Num(), *Position.ToString());
+	for (FRenderSection& Section : RenderResult.Sections)
+	{
+		UPrimitiveComponent* SectionComponent = GetOrCreateSectionComponent(Section.Index, RenderResult.Output);
+		if (UChunkCollisionComponent* CollisionComponent = Cast<UChunkCollisionComponent>(SectionComponent))
+		{
+			SectionQuads[Section.Index] = Section.Collision.NumTriangles() / 2;
+			SectionTranslucentQuads[Section.Index] = 0;
+			CollisionComponent->SetCollisionMesh(Section.Collision);
+			FChunkMeshBufferPool::Release(Section.Collision);
+		}
+		else if (UProceduralMeshComponent* ProceduralComponent = Cast<UProceduralMeshComponent>(SectionComponent))
+		{
+			ProceduralComponent->SetProcMeshSection(0, Section.Stream.Section);
+			ProceduralComponent->SetProcMeshSection(1, Section.TranslucentStream.Section);
+
+			// The component keeps copies, the buffers go back to the workers
+			SectionQuads[Section.Index] = Section.Stream.NumTriangles() / 2;
+			SectionTranslucentQuads[Section.Index] = Section.TranslucentStream.NumTriangles() / 2;
+			FChunkMeshBufferPool::Release(Section.Stream);
+			FChunkMeshBufferPool::Release(Section.TranslucentStream);
+		}
+		else
+		{
+			CastChecked<UDynamicMeshComponent>(SectionComponent)->SetMesh(MoveTemp(Section.Mesh));
+		}
+
+		// A later render may already be emitting it again with newer data
+		if (SectionRenderIds[Section.Index] <= RenderId)
+		{
+			DirtySections[Section.Index] = false;
+		}
+	}
 
 	// Spawn instances when chunk is first rendered
 	UE_LOG(LogChunk, Log, TEXT("[CommitRender] Calling SpawnInstancesFromEntities for chunk %s"), *Position.ToString());
@@ -649,3 +1310,80 @@ void AChunk::Cl_ShowInstance(const FPrimaryAssetId& TypeId, int32 InstanceIndex,
 		Comp->UpdateInstanceTransform(InstanceIndex, LocalTransform, false, true, true);
 	}
 }
+
+static FAutoConsoleCommand CmdMesherBenchmark(
+	TEXT("game.chunk.render.mesher_benchmark"),
+	TEXT("Meshes up to N loaded chunks (default 16) with each mesher output (dynamic mesh, raw streams, collision only), logs the ms, bytes and triangles per chunk of each"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const AGameManager* GameManager = Cast<AGameManager>(UGameplayStatics::GetActorOfClass(World, AGameManager::StaticClass()));
+		if (!GameManager || !GameManager->ChunkRegistry)
+		{
+			UE_LOG(LogChunk, Warning, TEXT("Mesher benchmark needs a running game"));
+			return;
+		}
+
+		const int32 MaxChunks = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 16;
+
+		TBitArray<> AllSections(true, AChunk::GetNumSections());
+		double Seconds[3] = {};
+		SIZE_T Bytes[3] = {};
+		int64 Triangles[3] = {};
+		int32 NumChunks = 0;
+		for (const auto& [ChunkPosition, Chunk] : GameManager->ChunkRegistry->GetChunkActors())
+		{
+			FRenderSnapshots Snapshots;
+			if (!Chunk || !GameManager->ChunkRegistry->Th_GetRenderSnapshots(ChunkPosition, Snapshots))
+			{
+				continue;
+			}
+
+			const FRenderColumnWindow Window(Snapshots);
+			for (const EChunkMeshOutput Output : {EChunkMeshOutput::DynamicMesh, EChunkMeshOutput::RawStream, EChunkMeshOutput::Collision})
+			{
+				const int32 OutputIndex = static_cast<int32>(Output);
+				FRenderResult Result;
+				const double Start = FPlatformTime::Seconds();
+				Chunk->BeginRender(Result, Window, AllSections, Chunk->GetSectionQuadHints(), Output, 0, false);
+				Seconds[OutputIndex] += FPlatformTime::Seconds() - Start;
+
+				for (const FRenderSection& Section : Result.Sections)
+				{
+					if (Output == EChunkMeshOutput::RawStream)
+					{
+						Bytes[OutputIndex] += Section.Stream.GetAllocatedSize() + Section.TranslucentStream.GetAllocatedSize();
+						Triangles[OutputIndex] += Section.Stream.NumTriangles() + Section.TranslucentStream.NumTriangles();
+					}
+					else if (Output == EChunkMeshOutput::Collision)
+					{
+						Bytes[OutputIndex] += Section.Collision.GetAllocatedSize();
+						Triangles[OutputIndex] += Section.Collision.NumTriangles();
+					}
+					else
+					{
+						Bytes[OutputIndex] += GetDynamicMeshAllocatedSize(Section.Mesh);
+						Triangles[OutputIndex] += Section.Mesh.TriangleCount();
+					}
+				}
+			}
+
+			if (++NumChunks >= MaxChunks)
+			{
+				break;
+			}
+		}
+
+		if (NumChunks == 0)
+		{
+			UE_LOG(LogChunk, Warning, TEXT("Mesher benchmark found no renderable chunk"));
+			return;
+		}
+
+		UE_LOG(LogChunk, Display, TEXT("Meshed %d chunks"), NumChunks);
+		UE_LOG(LogChunk, Display, TEXT("  FDynamicMesh3: %.3f ms, %llu bytes, %lld triangles per chunk"),
+			Seconds[0] * 1000.0 / NumChunks, static_cast<uint64>(Bytes[0] / NumChunks), Triangles[0] / NumChunks);
+		UE_LOG(LogChunk, Display, TEXT("  Raw streams: %.3f ms, %llu bytes, %lld triangles per chunk"),
+			Seconds[1] * 1000.0 / NumChunks, static_cast<uint64>(Bytes[1] / NumChunks), Triangles[1] / NumChunks);
+		UE_LOG(LogChunk, Display, TEXT("  Collision only: %.3f ms, %llu bytes, %lld triangles per chunk"),
+			Seconds[2] * 1000.0 / NumChunks, static_cast<uint64>(Bytes[2] / NumChunks), Triangles[2] / NumChunks);
+	}));
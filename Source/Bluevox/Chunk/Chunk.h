@@ -3,16 +3,21 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Bluevox/Game/GameConstants.h"
 #include "Bluevox/Game/VoxelMaterial.h"
 #include "Bluevox/Tick/GameTickable.h"
+#include "Bluevox/Utils/Face.h"
+#include "ChunkMeshStream.h"
+#include "Data/ChunkColumnStorage.h"
+#include "Data/ChunkSnapshot.h"
 #include "Data/Piece.h"
 #include "Position/ChunkPosition.h"
 #include "VirtualMap/ChunkState.h"
 #include "Chunk.generated.h"
 
 struct FRenderResult;
+struct FRenderSection;
 struct FRenderGroup;
-struct FChunkColumn;
 class UShape;
 struct FPiece;
 class AGameManager;
@@ -23,13 +28,50 @@ namespace UE::Geometry
 	class FDynamicMesh3;
 }
 
-class UChunkData;
-class UDynamicMeshComponent;
+class FChunkData;
+class UPrimitiveComponent;
 class UHierarchicalInstancedStaticMeshComponent;
 
+// Everything the mesher reads: the chunk and its 4 horizontal neighbors, indexed by EFace
+struct FRenderSnapshots
+{
+	FChunkSnapshot Center;
+	TStaticArray<FChunkSnapshot, 4> Neighbors;
+};
+
+/**
+ * Column views of a chunk ringed by the border columns of its 4 neighbors, (Size + 2)^2 of them resolved once per
+ * render so the mesher reads any column or its neighbor by index, without touching the snapshots again.
+ * Corners are left empty, the mesher never looks diagonally.
+ */
+struct FRenderColumnWindow
+{
+	explicit FRenderColumnWindow(const FRenderSnapshots& Snapshots);
+
+	int32 GetIndex(const int32 LocalX, const int32 LocalY) const
+	{
+		return LocalX + 1 + (LocalY + 1) * Stride;
+	}
+
+	// Index offset from a column to its neighbor on a horizontal face
+	int32 GetFaceOffset(const EFace Face) const;
+
+	int32 Stride = 0;
+
+	TArray<FChunkColumnView> Columns;
+};
+
+// Quads each section was last committed with, copied on the game thread so the mesher sizes its buffers from them
+// without reading the chunk while a commit updates it. INDEX_NONE for the sections never committed
+struct FSectionQuadHints
+{
+	TArray<int32> Quads;
+
+	TArray<int32> TranslucentQuads;
+};
+
 struct FRenderNeighbor {
-	const FChunkColumn* Column = nullptr;
-	const FPiece* Piece = nullptr;
+	FChunkColumnView Column;
 	EMaterial MaterialId = EMaterial::Void;
 	int32 Start = 0;
 	int32 Size = 0;
@@ -44,13 +86,29 @@ class BLUEVOX_API AChunk : public AActor, public IGameTickable
 	friend class UChunkRegistry;
 	
 protected:
-	UPROPERTY(EditAnywhere)
-	UDynamicMeshComponent* MeshComponent = nullptr;
+	// One per section of SectionSize x SectionSize columns, created the first time the section is committed.
+	// Procedural, dynamic mesh or collision components, depending on the output the section was emitted with
+	UPROPERTY()
+	TArray<UPrimitiveComponent*> SectionComponents;
 
 	UPROPERTY()
 	TMap<FPrimaryAssetId, UHierarchicalInstancedStaticMeshComponent*> ChunkInstanceComponents;
 
-	FThreadSafeCounter RenderedAtDirtyChanges = -1;
+	// Sections waiting for a committed render, game thread only
+	TBitArray<> DirtySections;
+
+	// Last render each section was handed to, it's only clean once a render at least that recent is committed
+	TArray<int32> SectionRenderIds;
+
+	// Quads each section was last committed with, game thread only. The mesher reads the copy PrepareRender makes
+	TArray<int32> SectionQuads;
+
+	TArray<int32> SectionTranslucentQuads;
+
+	bool bSectionsVisible = true;
+
+	// LOD the sections are emitted at, changing it re-emits all of them
+	int32 RenderLod = 0;
 
 	// Track if instances have been spawned for this chunk
 	bool bInstancesSpawned = false;
@@ -61,25 +119,73 @@ protected:
 	UPROPERTY(EditAnywhere)
 	FChunkPosition Position;
 
+	// Replaces the current component of the section when it was made for another output
+	UPrimitiveComponent* GetOrCreateSectionComponent(const int32 SectionIndex, const EChunkMeshOutput Output);
+
+	// Emits the columns of one section into its own buffers, safe to run for several sections at once
+	void BuildSection(FRenderSection& Section, const FRenderColumnWindow& Window, const FSectionQuadHints& QuadHints,
+	                  const EChunkMeshOutput Output, const int32 Lod) const;
+
 public:
 	virtual void BeginDestroy() override;
 	
 	// Sets default values for this actor's properties
 	AChunk();
 	
-	AChunk* Init(const FChunkPosition InPosition, AGameManager* InGameManager, UChunkData* InData);
+	AChunk* Init(const FChunkPosition InPosition, AGameManager* InGameManager, FChunkData* InData);
 
 	// Spawn HISM instances from entity records
 	void InitialSpawnInstancesFromEntities();
 
-	UPROPERTY()
-	UChunkData* ChunkData;
-	
-	void SetRenderState(EChunkState State) const;
+	// Owned by the registry chunk data store, outlives the actor. Swapped by the registry when the position is registered again
+	FChunkData* ChunkData = nullptr;
 	
-	bool BeginRender(UE::Geometry::FDynamicMesh3& OutMesh, bool bForceRender = false);
+	void SetRenderState(EChunkState State);
+
+	static int32 GetNumSectionsPerSide()
+	{
+		return FMath::DivideAndRoundUp(GameConstants::Chunk::Size, GameConstants::Chunk::Render::SectionSize);
+	}
+
+	static int32 GetNumSections()
+	{
+		return FMath::Square(GetNumSectionsPerSide());
+	}
+
+	static int32 GetSectionIndex(const int32 LocalX, const int32 LocalY)
+	{
+		const int32 SectionSize = GameConstants::Chunk::Render::SectionSize;
+		return LocalX / SectionSize + LocalY / SectionSize * GetNumSectionsPerSide();
+	}
+
+	// Game thread. Turns the dirty columns of the data into the sections the render has to emit
+	void PrepareRender(const int32 RenderId, const bool bFullRender, TBitArray<>& OutSections, FSectionQuadHints& OutQuadHints);
+
+	// Game thread
+	FSectionQuadHints GetSectionQuadHints() const
+	{
+		return FSectionQuadHints{SectionQuads, SectionTranslucentQuads};
+	}
+
+	static EChunkMeshOutput GetMeshOutput()
+	{
+		return GameConstants::Chunk::Render::bRawMeshStreams ? EChunkMeshOutput::RawStream : EChunkMeshOutput::DynamicMesh;
+	}
+
+	// Chunks nobody sees locally only build their collision
+	static EChunkMeshOutput GetMeshOutput(const EChunkState State)
+	{
+		return EnumHasAnyFlags(State, EChunkState::Visible) ? GetMeshOutput() : EChunkMeshOutput::Collision;
+	}
+
+	// Priority renders build their sections in parallel over all the workers, the others on the calling thread
+	bool BeginRender(FRenderResult& OutResult, const FRenderColumnWindow& Window, const TBitArray<>& Sections,
+	                 const FSectionQuadHints& QuadHints, const EChunkMeshOutput Output, const int32 Lod, const bool bPriority);
+
+	void CommitRender(const int32 RenderId, FRenderResult&& RenderResult);
 
-	void CommitRender(FRenderResult&& RenderResult);
+	// Estimate of the memory taken by the committed section meshes
+	SIZE_T GetMeshAllocatedSize() const;
 
 	// Client-side helpers to sync instances when entities are spawned/despawned
 	UFUNCTION()
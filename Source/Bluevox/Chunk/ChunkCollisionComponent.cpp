@@ -0,0 +1,105 @@
+﻿#include "ChunkCollisionComponent.h"
+
+#include "PhysicsEngine/BodySetup.h"
+
+UChunkCollisionComponent::UChunkCollisionComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+	SetCastShadow(false);
+}
+
+void UChunkCollisionComponent::SetCollisionMesh(FChunkCollisionStream& Stream)
+{
+	Swap(Positions, Stream.Positions);
+	Swap(Indices, Stream.Indices);
+
+	LocalBounds.Init();
+	for (const FVector3f& Position : Positions)
+	{
+		LocalBounds += FVector(Position);
+	}
+	UpdateBounds();
+
+	// Cooks still in flight are older than this mesh, they must not bring their collision back once done
+	AsyncBodySetupQueue.Reset();
+
+	if (Indices.IsEmpty())
+	{
+		BodySetup = CreateBodySetup();
+		RecreatePhysicsState();
+		return;
+	}
+
+	// A new body setup per cook, the one in use can't change under the physics scene
+	UBodySetup* NewBodySetup = CreateBodySetup();
+	AsyncBodySetupQueue.Add(NewBodySetup);
+	NewBodySetup->CreatePhysicsMeshesAsync(FOnAsyncPhysicsCookFinished::CreateUObject(
+		this, &UChunkCollisionComponent::FinishPhysicsAsyncCook, NewBodySetup));
+}
+
+bool UChunkCollisionComponent::GetPhysicsTriMeshData(FTriMeshCollisionData* CollisionData, bool InUseAllTriData)
+{
+	CollisionData->Vertices = Positions;
+	CollisionData->Indices.SetNumUninitialized(Indices.Num() / 3);
+	for (int32 Triangle = 0; Triangle < CollisionData->Indices.Num(); ++Triangle)
+	{
+		FTriIndices& TriIndices = CollisionData->Indices[Triangle];
+		TriIndices.v0 = Indices[Triangle * 3];
+		TriIndices.v1 = Indices[Triangle * 3 + 1];
+		TriIndices.v2 = Indices[Triangle * 3 + 2];
+	}
+	CollisionData->bFlipNormals = true;
+	CollisionData->bDeformableMesh = true;
+	CollisionData->bFastCook = true;
+	return true;
+}
+
+bool UChunkCollisionComponent::ContainsPhysicsTriMeshData(bool InUseAllTriData) const
+{
+	return Indices.Num() > 0;
+}
+
+UBodySetup* UChunkCollisionComponent::GetBodySetup()
+{
+	if (!BodySetup)
+	{
+		BodySetup = CreateBodySetup();
+	}
+	return BodySetup;
+}
+
+FBoxSphereBounds UChunkCollisionComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+	if (!LocalBounds.IsValid)
+	{
+		return FBoxSphereBounds(LocalToWorld.GetLocation(), FVector::ZeroVector, 0.0f);
+	}
+	return FBoxSphereBounds(LocalBounds).TransformBy(LocalToWorld);
+}
+
+UBodySetup* UChunkCollisionComponent::CreateBodySetup()
+{
+	UBodySetup* NewBodySetup = NewObject<UBodySetup>(this, NAME_None, RF_Transient);
+	NewBodySetup->BodySetupGuid = FGuid::NewGuid();
+	NewBodySetup->bGenerateMirroredCollision = false;
+	NewBodySetup->bDoubleSidedGeometry = true;
+	NewBodySetup->CollisionTraceFlag = CTF_UseComplexAsSimple;
+	return NewBodySetup;
+}
+
+void UChunkCollisionComponent::FinishPhysicsAsyncCook(bool bSuccess, UBodySetup* FinishedBodySetup)
+{
+	// Cooks finish in any order, one already superseded by a newer mesh is dropped
+	if (AsyncBodySetupQueue.IsEmpty() || AsyncBodySetupQueue.Last() != FinishedBodySetup)
+	{
+		AsyncBodySetupQueue.Remove(FinishedBodySetup);
+		return;
+	}
+
+	AsyncBodySetupQueue.Reset();
+	if (bSuccess)
+	{
+		BodySetup = FinishedBodySetup;
+		RecreatePhysicsState();
+	}
+}
@@ -0,0 +1,67 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "ChunkMeshStream.h"
+#include "Components/PrimitiveComponent.h"
+#include "Interfaces/Interface_CollisionDataProvider.h"
+#include "ChunkCollisionComponent.generated.h"
+
+class UBodySetup;
+
+/**
+ * Physics only mesh of a chunk section: a triangle mesh cooked for collision, with no scene proxy and no render
+ * data at all. Used for chunks that are live for remote players only.
+ */
+UCLASS()
+class BLUEVOX_API UChunkCollisionComponent : public UPrimitiveComponent, public IInterface_CollisionDataProvider
+{
+	GENERATED_BODY()
+
+public:
+	UChunkCollisionComponent();
+
+	// Cooks the new mesh in the background, the previous one keeps colliding until it's done.
+	// Swaps the buffers with the stream, which gets the ones of the previous mesh back
+	void SetCollisionMesh(FChunkCollisionStream& Stream);
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return Positions.GetAllocatedSize() + Indices.GetAllocatedSize();
+	}
+
+	virtual bool GetPhysicsTriMeshData(FTriMeshCollisionData* CollisionData, bool InUseAllTriData) override;
+
+	virtual bool ContainsPhysicsTriMeshData(bool InUseAllTriData) const override;
+
+	virtual bool WantsNegXTriMesh() override
+	{
+		return false;
+	}
+
+	virtual UBodySetup* GetBodySetup() override;
+
+	virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+
+	virtual FPrimitiveSceneProxy* CreateSceneProxy() override
+	{
+		return nullptr;
+	}
+
+private:
+	UPROPERTY(Transient)
+	UBodySetup* BodySetup = nullptr;
+
+	// Cooks in flight, oldest first. Only the newest is applied once done, the ones before are stale by then
+	UPROPERTY(Transient)
+	TArray<UBodySetup*> AsyncBodySetupQueue;
+
+	TArray<FVector3f> Positions;
+
+	TArray<uint32> Indices;
+
+	FBox LocalBounds = FBox(ForceInit);
+
+	UBodySetup* CreateBodySetup();
+
+	void FinishPhysicsAsyncCook(bool bSuccess, UBodySetup* FinishedBodySetup);
+};
@@ -4,6 +4,8 @@
 #include "ChunkHelper.h"
 
 #include "Position/ChunkPosition.h"
+#include "Bluevox/Game/GameConstants.h"
+#include "VirtualMap/ChunkState.h"
 
 void UChunkHelper::GetBorderChunks(const FChunkPosition& GlobalPosition, const int32 Distance,
 	TSet<FChunkPosition>& OutPositions)
@@ -78,3 +80,15 @@ int32 UChunkHelper::GetDistance(const FChunkPosition& A, const FChunkPosition& B
 {
 	return FMath::Max(FMath::Abs(A.X - B.X), FMath::Abs(A.Y - B.Y));
 }
+
+int32 UChunkHelper::GetLodForDistance(const int32 Distance)
+{
+	const int32 StartDistance = GameConstants::Chunk::Lod::StartDistance;
+	if (StartDistance <= 0 || Distance < StartDistance)
+	{
+		return 0;
+	}
+
+	const int32 Doublings = static_cast<int32>(FMath::FloorLog2(static_cast<uint32>(Distance / StartDistance)));
+	return FMath::Min(1 + Doublings, ChunkStateUtils::MaxLod);
+}
@@ -26,4 +26,7 @@ public:
 	static void GetChunksAround(const FChunkPosition& GlobalPosition, int32 Distance, TSet<FChunkPosition>& OutPositions);
 
 	static int32 GetDistance(const FChunkPosition& A, const FChunkPosition& B);
+
+	// Mesh LOD of a chunk Distance chunks away from the local player
+	static int32 GetLodForDistance(const int32 Distance);
 };
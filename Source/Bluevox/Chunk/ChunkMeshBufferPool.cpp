@@ -0,0 +1,99 @@
+﻿#include "ChunkMeshBufferPool.h"
+
+#include "Bluevox/Game/GameConstants.h"
+
+namespace
+{
+	// Buffers taken from the shared list at once, so a worker doesn't lock it for every section
+	constexpr int32 RefillCount = 8;
+
+	template <typename StreamType>
+	struct TSharedStreams
+	{
+		FCriticalSection Lock;
+
+		TArray<StreamType> Streams;
+	};
+
+	template <typename StreamType>
+	TSharedStreams<StreamType>& GetSharedStreams()
+	{
+		static TSharedStreams<StreamType> Shared;
+		return Shared;
+	}
+
+	template <typename StreamType>
+	TArray<StreamType>& GetLocalStreams()
+	{
+		thread_local TArray<StreamType> Local;
+		return Local;
+	}
+
+	template <typename StreamType>
+	void AcquireStream(StreamType& OutStream, const int32 NumQuads)
+	{
+		TArray<StreamType>& Local = GetLocalStreams<StreamType>();
+		if (Local.IsEmpty())
+		{
+			TSharedStreams<StreamType>& Shared = GetSharedStreams<StreamType>();
+			FScopeLock ScopeLock(&Shared.Lock);
+			for (int32 Count = 0; Count < RefillCount && !Shared.Streams.IsEmpty(); ++Count)
+			{
+				Local.Add(Shared.Streams.Pop(EAllowShrinking::No));
+			}
+		}
+
+		if (!Local.IsEmpty())
+		{
+			OutStream = Local.Pop(EAllowShrinking::No);
+			OutStream.Reset();
+		}
+		OutStream.Reserve(NumQuads);
+	}
+
+	template <typename StreamType>
+	void ReleaseStream(StreamType& Stream)
+	{
+		const int32 PoolSize = GameConstants::Chunk::Render::BufferPoolSize;
+		if (IsInGameThread())
+		{
+			TSharedStreams<StreamType>& Shared = GetSharedStreams<StreamType>();
+			FScopeLock ScopeLock(&Shared.Lock);
+			if (Shared.Streams.Num() < PoolSize)
+			{
+				Shared.Streams.Add(MoveTemp(Stream));
+			}
+		}
+		else
+		{
+			TArray<StreamType>& Local = GetLocalStreams<StreamType>();
+			if (Local.Num() < PoolSize)
+			{
+				Local.Add(MoveTemp(Stream));
+			}
+		}
+
+		// Whatever didn't fit is freed here
+		Stream = StreamType();
+	}
+}
+
+void FChunkMeshBufferPool::Acquire(FChunkMeshStream& OutStream, const int32 NumQuads)
+{
+	AcquireStream(OutStream, NumQuads);
+}
+
+void FChunkMeshBufferPool::Acquire(FChunkCollisionStream& OutStream, const int32 NumQuads)
+{
+	AcquireStream(OutStream, NumQuads);
+}
+
+void FChunkMeshBufferPool::Release(FChunkMeshStream& Stream)
+{
+	ReleaseStream(Stream);
+}
+
+void FChunkMeshBufferPool::Release(FChunkCollisionStream& Stream)
+{
+	ReleaseStream(Stream);
+}
@@ -0,0 +1,24 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "ChunkMeshStream.h"
+
+/**
+ * Vertex and index buffers of the mesher, handed back once their section is committed and reused by the next
+ * render instead of being freed, so streaming a burst of chunks in doesn't go to the allocator for every section.
+ * Each render worker keeps the buffers it reuses to itself, committed buffers come back from the game thread
+ * through a shared list the workers refill from.
+ */
+class BLUEVOX_API FChunkMeshBufferPool
+{
+public:
+	// Empty buffers with room for about NumQuads, recycled ones when the calling thread or the shared list has some
+	static void Acquire(FChunkMeshStream& OutStream, const int32 NumQuads);
+
+	static void Acquire(FChunkCollisionStream& OutStream, const int32 NumQuads);
+
+	// Keeps the buffers of the stream for a later Acquire, or frees them when the pool is full. Leaves it empty
+	static void Release(FChunkMeshStream& Stream);
+
+	static void Release(FChunkCollisionStream& Stream);
+};
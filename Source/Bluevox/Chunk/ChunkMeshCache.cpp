@@ -0,0 +1,303 @@
+﻿#include "ChunkMeshCache.h"
+
+#include "Chunk.h"
+#include "ChunkStats.h"
+#include "LogChunk.h"
+#include "Bluevox/Game/GameConstants.h"
+#include "Bluevox/Game/GameManager.h"
+#include "Bluevox/Game/WorldSave.h"
+#include "Hash/xxhash.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Serialization/ArchiveLoadCompressedProxy.h"
+#include "Serialization/ArchiveSaveCompressedProxy.h"
+#include "Serialization/BufferArchive.h"
+#include "VirtualMap/ChunkTaskManager.h"
+
+namespace
+{
+	// Only the vertex attributes the mesher fills are written
+	void SerializeStream(FArchive& Ar, FChunkMeshStream& Stream)
+	{
+		FProcMeshSection& Section = Stream.Section;
+
+		int32 NumVertices = Section.ProcVertexBuffer.Num();
+		Ar << NumVertices;
+		if (Ar.IsLoading())
+		{
+			Section.ProcVertexBuffer.SetNum(NumVertices);
+		}
+
+		for (FProcMeshVertex& Vertex : Section.ProcVertexBuffer)
+		{
+			Ar << Vertex.Position;
+			Ar << Vertex.Normal;
+			Ar << Vertex.Tangent.TangentX;
+			Ar << Vertex.Tangent.bFlipTangentY;
+			Ar << Vertex.UV0;
+			Ar << Vertex.UV1;
+		}
+
+		Ar << Section.ProcIndexBuffer;
+		Ar << Section.SectionLocalBox;
+		Ar << Section.bEnableCollision;
+	}
+
+	void SerializeResult(FArchive& Ar, FRenderResult& Result)
+	{
+		int32 NumSections = Result.Sections.Num();
+		Ar << NumSections;
+		if (Ar.IsLoading())
+		{
+			Result.Sections.SetNum(NumSections);
+		}
+
+		for (FRenderSection& Section : Result.Sections)
+		{
+			Ar << Section.Index;
+			if (Result.Output == EChunkMeshOutput::Collision)
+			{
+				Ar << Section.Collision.Positions;
+				Ar << Section.Collision.Indices;
+			}
+			else
+			{
+				SerializeStream(Ar, Section.Stream);
+				SerializeStream(Ar, Section.TranslucentStream);
+			}
+		}
+	}
+}
+
+FChunkMeshCache::FChunkMeshCache(const FString& InDirectory)
+	: Directory(InDirectory)
+{
+	IFileManager::Get().MakeDirectory(*Directory, true);
+
+	// Picks up what previous sessions left, the modification time of an entry is when it was last used
+	IFileManager::Get().IterateDirectoryStat(*Directory,
+		[this](const TCHAR* Path, const FFileStatData& Stat)
+		{
+			const FString Name = FPaths::GetBaseFilename(Path);
+			if (Stat.bIsDirectory || FPaths::GetExtension(Path) != TEXT("mesh") || Name.Len() != 16)
+			{
+				return true;
+			}
+
+			Entries.Add(FParse::HexNumber64(*Name), FEntry{Stat.FileSize, Stat.ModificationTime});
+			TotalBytes += Stat.FileSize;
+			return true;
+		});
+
+	EvictOverBudget();
+	SET_MEMORY_STAT(STAT_ChunkMeshCache_Bytes, TotalBytes);
+
+	UE_LOG(LogChunk, Log, TEXT("Chunk mesh cache at %s: %d entries, %lld bytes"), *Directory, Entries.Num(), TotalBytes);
+}
+
+uint64 FChunkMeshCache::MakeKey(const FChunkPosition& Position, const FRenderColumnWindow& Window,
+	const EChunkMeshOutput Output, const int32 Lod)
+{
+	// Mesher settings first, changing any of them misses every entry instead of serving stale meshes
+	const int32 Settings[] = {
+		GameConstants::Chunk::MeshCache::FileVersion,
+		GameConstants::Chunk::Size,
+		GameConstants::Chunk::Render::SectionSize,
+		GameConstants::Chunk::Render::bGreedyMeshing ? 1 : 0,
+		GameConstants::Chunk::Render::WaterViewDepth,
+		static_cast<int32>(Output),
+		Lod,
+		// UVs are in world space, the same columns somewhere else are another mesh
+		Position.X,
+		Position.Y
+	};
+
+	FXxHash64Builder Builder;
+	Builder.Update(Settings, sizeof(Settings));
+
+	// Decoded pieces, the same columns packed against another palette must give the same key
+	TArray<uint32> Pieces;
+	Pieces.Reserve(Window.Columns.Num() * 4);
+	for (const FChunkColumnView& Column : Window.Columns)
+	{
+		Pieces.Add(Column.Num());
+		for (const FPiece Piece : Column)
+		{
+			Pieces.Add(static_cast<uint32>(Piece.MaterialId) << 16 | Piece.Size);
+		}
+	}
+	Builder.Update(Pieces.GetData(), Pieces.Num() * Pieces.GetTypeSize());
+
+	return Builder.Finalize().Hash;
+}
+
+bool FChunkMeshCache::IsCacheable(const TBitArray<>& Sections, const EChunkMeshOutput Output)
+{
+	// Dynamic meshes are the fallback mesher output, not worth a file format of their own
+	return Output != EChunkMeshOutput::DynamicMesh && Sections.Find(false) == INDEX_NONE;
+}
+
+bool FChunkMeshCache::Th_Load(const uint64 Key, FRenderResult& OutResult)
+{
+	bool bKnown;
+	{
+		FReadScopeLock ReadLock(Lock);
+		bKnown = Entries.Contains(Key);
+	}
+
+	TArray<uint8> Compressed;
+	if (!bKnown || !FFileHelper::LoadFileToArray(Compressed, *GetEntryPath(Key), FILEREAD_Silent))
+	{
+		++NumMisses;
+		INC_DWORD_STAT(STAT_ChunkMeshCache_Misses);
+		return false;
+	}
+
+	FArchiveLoadCompressedProxy Decompressor(Compressed, NAME_Zlib);
+	FBufferArchive Uncompressed;
+	Decompressor << Uncompressed;
+	Decompressor.Close();
+
+	FMemoryReader Reader(Uncompressed, true);
+	int32 FileVersion = 0;
+	uint64 FileKey = 0;
+	uint8 Output = 0;
+	Reader << FileVersion;
+	Reader << FileKey;
+	Reader << Output;
+	if (Decompressor.GetError() || FileVersion != GameConstants::Chunk::MeshCache::FileVersion || FileKey != Key)
+	{
+		UE_LOG(LogChunk, Warning, TEXT("Discarding unreadable chunk mesh cache entry %016llx"), Key);
+		++NumMisses;
+		INC_DWORD_STAT(STAT_ChunkMeshCache_Misses);
+		return false;
+	}
+
+	OutResult.Output = static_cast<EChunkMeshOutput>(Output);
+	SerializeResult(Reader, OutResult);
+	if (Reader.IsError())
+	{
+		UE_LOG(LogChunk, Warning, TEXT("Discarding truncated chunk mesh cache entry %016llx"), Key);
+		OutResult.Sections.Reset();
+		++NumMisses;
+		INC_DWORD_STAT(STAT_ChunkMeshCache_Misses);
+		return false;
+	}
+
+	const FDateTime Now = FDateTime::UtcNow();
+	{
+		FWriteScopeLock WriteLock(Lock);
+		if (FEntry* Entry = Entries.Find(Key))
+		{
+			Entry->LastUsed = Now;
+		}
+	}
+	IFileManager::Get().SetTimeStamp(*GetEntryPath(Key), Now);
+
+	++NumHits;
+	INC_DWORD_STAT(STAT_ChunkMeshCache_Hits);
+	return true;
+}
+
+TArray<uint8> FChunkMeshCache::Th_Serialize(const uint64 Key, const FRenderResult& Result)
+{
+	FBufferArchive Uncompressed;
+	int32 FileVersion = GameConstants::Chunk::MeshCache::FileVersion;
+	uint64 FileKey = Key;
+	uint8 Output = static_cast<uint8>(Result.Output);
+	Uncompressed << FileVersion;
+	Uncompressed << FileKey;
+	Uncompressed << Output;
+
+	// Saving never writes into the result, the archive API only takes it mutable
+	SerializeResult(Uncompressed, const_cast<FRenderResult&>(Result));
+
+	return MoveTemp(Uncompressed);
+}
+
+void FChunkMeshCache::Th_Store(const uint64 Key, TArray<uint8>&& Uncompressed)
+{
+	TArray<uint8> Compressed;
+	FArchiveSaveCompressedProxy Compressor(Compressed, NAME_Zlib);
+	Compressor << Uncompressed;
+	Compressor.Close();
+
+	if (Compressor.GetError() || !FFileHelper::SaveArrayToFile(Compressed, *GetEntryPath(Key)))
+	{
+		UE_LOG(LogChunk, Warning, TEXT("Failed to write chunk mesh cache entry %016llx"), Key);
+		return;
+	}
+
+	FWriteScopeLock WriteLock(Lock);
+	FEntry& Entry = Entries.FindOrAdd(Key);
+	TotalBytes += Compressed.Num() - Entry.Size;
+	Entry.Size = Compressed.Num();
+	Entry.LastUsed = FDateTime::UtcNow();
+
+	EvictOverBudget();
+	SET_MEMORY_STAT(STAT_ChunkMeshCache_Bytes, TotalBytes);
+}
+
+void FChunkMeshCache::LogStats() const
+{
+	const int32 Hits = NumHits;
+	const int32 Lookups = Hits + NumMisses;
+
+	FReadScopeLock ReadLock(Lock);
+	UE_LOG(LogChunk, Display, TEXT("Chunk mesh cache: %d hits in %d lookups (%.1f%%), %d entries, %lld of %d MB, %d evicted"),
+		Hits, Lookups, Lookups > 0 ? 100.0 * Hits / Lookups : 0.0, Entries.Num(), TotalBytes,
+		GameConstants::Chunk::MeshCache::BudgetMB, NumEvictions.load());
+}
+
+FString FChunkMeshCache::GetEntryPath(const uint64 Key) const
+{
+	return Directory / FString::Printf(TEXT("%016llx.mesh"), Key);
+}
+
+void FChunkMeshCache::EvictOverBudget()
+{
+	const int64 Budget = static_cast<int64>(GameConstants::Chunk::MeshCache::BudgetMB) * 1024 * 1024;
+	if (TotalBytes <= Budget)
+	{
+		return;
+	}
+
+	// Down to 90% of the budget, so a full cache doesn't sort its entries on every store
+	TArray<TPair<FDateTime, uint64>> ByAge;
+	ByAge.Reserve(Entries.Num());
+	for (const auto& [Key, Entry] : Entries)
+	{
+		ByAge.Emplace(Entry.LastUsed, Key);
+	}
+	ByAge.Sort([](const TPair<FDateTime, uint64>& A, const TPair<FDateTime, uint64>& B)
+	{
+		return A.Key < B.Key;
+	});
+
+	const int64 Target = Budget / 10 * 9;
+	for (int32 Index = 0; Index < ByAge.Num() && TotalBytes > Target; ++Index)
+	{
+		const uint64 Key = ByAge[Index].Value;
+		IFileManager::Get().Delete(*GetEntryPath(Key), false, false, true);
+		TotalBytes -= Entries.FindAndRemoveChecked(Key).Size;
+		++NumEvictions;
+	}
+}
+
+static FAutoConsoleCommand CmdMeshCacheStats(
+	TEXT("game.chunk.mesh_cache.stats"),
+	TEXT("Logs the hit rate, entries and disk usage of the chunk mesh cache"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const AGameManager* GameManager = Cast<AGameManager>(UGameplayStatics::GetActorOfClass(World, AGameManager::StaticClass()));
+		const FChunkMeshCache* MeshCache = GameManager && GameManager->ChunkTaskManager
+			? GameManager->ChunkTaskManager->GetMeshCache() : nullptr;
+		if (!MeshCache)
+		{
+			UE_LOG(LogChunk, Warning, TEXT("The chunk mesh cache is disabled or no world is loaded"));
+			return;
+		}
+
+		MeshCache->LogStats();
+	}));
@@ -0,0 +1,66 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+#include "Position/ChunkPosition.h"
+
+struct FRenderResult;
+struct FRenderColumnWindow;
+enum class EChunkMeshOutput : uint8;
+
+/**
+ * Chunk meshes kept on disk next to the region files, so a chunk streaming back in with the voxels it had when it
+ * was last meshed skips the mesher and goes straight to CommitRender.
+ * Entries are keyed by the columns of the chunk and the border columns of its neighbors, the only ones the mesher
+ * reads, and dropped least recently used first once the cache grows over game.chunk.mesh_cache.budget_mb.
+ * Thread safe.
+ */
+class BLUEVOX_API FChunkMeshCache
+{
+public:
+	explicit FChunkMeshCache(const FString& InDirectory);
+
+	// Everything the mesh depends on: the columns it is built from, where it is and how it is meshed
+	static uint64 MakeKey(const FChunkPosition& Position, const FRenderColumnWindow& Window,
+	                      const EChunkMeshOutput Output, const int32 Lod);
+
+	// Only renders of the whole chunk are kept, the partial ones come from edits and would never be hit again
+	static bool IsCacheable(const TBitArray<>& Sections, const EChunkMeshOutput Output);
+
+	bool Th_Load(const uint64 Key, FRenderResult& OutResult);
+
+	// The uncompressed entry of a result, cheap enough for the render job, the result goes on to the commit after it
+	static TArray<uint8> Th_Serialize(const uint64 Key, const FRenderResult& Result);
+
+	// Compresses and writes an entry from Th_Serialize, slow enough that it belongs on the save lane
+	void Th_Store(const uint64 Key, TArray<uint8>&& Uncompressed);
+
+	void LogStats() const;
+
+private:
+	struct FEntry
+	{
+		int64 Size = 0;
+
+		FDateTime LastUsed;
+	};
+
+	FString GetEntryPath(const uint64 Key) const;
+
+	// Drops the least recently used entries until the cache fits in its budget again. Needs Lock
+	void EvictOverBudget();
+
+	FString Directory;
+
+	mutable FRWLock Lock;
+
+	TMap<uint64, FEntry> Entries;
+
+	int64 TotalBytes = 0;
+
+	std::atomic<int32> NumHits = 0;
+
+	std::atomic<int32> NumMisses = 0;
+
+	std::atomic<int32> NumEvictions = 0;
+};
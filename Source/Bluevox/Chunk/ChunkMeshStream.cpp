@@ -0,0 +1,45 @@
+﻿#include "ChunkMeshStream.h"
+
+void FChunkMeshStream::Reserve(const int32 NumQuads)
+{
+	Section.ProcVertexBuffer.Reserve(NumQuads * 4);
+	Section.ProcIndexBuffer.Reserve(NumQuads * 6);
+	Section.bEnableCollision = true;
+}
+
+void FChunkMeshStream::Reset()
+{
+	Section.ProcVertexBuffer.Reset();
+	Section.ProcIndexBuffer.Reset();
+	Section.SectionLocalBox.Init();
+}
+
+void FChunkMeshStream::AddQuad(const FVector3f& V0, const FVector3f& V1, const FVector3f& V2, const FVector3f& V3,
+                               const FVector2f& UV0, const FVector2f& UV1, const FVector2f& UV2, const FVector2f& UV3,
+                               const float TextureIndex, const FVector3f& Normal)
+{
+	// Tangent follows U across the face, V0 -> V1 or V0 -> V3 depending on which edge U changes along
+	const bool bUAlongFirstEdge = !FMath::IsNearlyEqual(UV0.X, UV1.X);
+	const FVector3f UEdge = bUAlongFirstEdge ? V1 - V0 : V3 - V0;
+	const float UDelta = bUAlongFirstEdge ? UV1.X - UV0.X : UV3.X - UV0.X;
+	const FProcMeshTangent Tangent(FVector(UEdge.GetSafeNormal() * FMath::Sign(UDelta)), false);
+	const FVector2D LayerUV(TextureIndex, 0.0);
+
+	const uint32 First = Section.ProcVertexBuffer.Num();
+	auto AddVertex = [this, &Normal, &Tangent, &LayerUV](const FVector3f& Position, const FVector2f& UV)
+	{
+		FProcMeshVertex& Vertex = Section.ProcVertexBuffer.AddDefaulted_GetRef();
+		Vertex.Position = FVector(Position);
+		Vertex.Normal = FVector(Normal);
+		Vertex.Tangent = Tangent;
+		Vertex.UV0 = FVector2D(UV);
+		Vertex.UV1 = LayerUV;
+		Section.SectionLocalBox += Vertex.Position;
+	};
+	AddVertex(V0, UV0);
+	AddVertex(V1, UV1);
+	AddVertex(V2, UV2);
+	AddVertex(V3, UV3);
+
+	Section.ProcIndexBuffer.Append({First, First + 1, First + 2, First, First + 2, First + 3});
+}
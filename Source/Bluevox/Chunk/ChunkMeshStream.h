@@ -0,0 +1,88 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "ProceduralMeshComponent.h"
+
+enum class EChunkMeshOutput : uint8
+{
+	// Half-edge mesh for a UDynamicMeshComponent
+	DynamicMesh,
+
+	// Packed vertex buffers for a UProceduralMeshComponent
+	RawStream,
+
+	// Positions and indices only, for a UChunkCollisionComponent
+	Collision
+};
+
+/**
+ * Mesher output written straight into the vertex and index buffers of a procedural mesh section.
+ * Unlike FDynamicMesh3 there's no topology nor overlay bookkeeping: a quad is 4 vertices and 6 indices appended to
+ * buffers reserved up front, and the section is handed to the component as is.
+ */
+struct BLUEVOX_API FChunkMeshStream
+{
+	FProcMeshSection Section;
+
+	void Reserve(const int32 NumQuads);
+
+	// Empties the buffers, keeping their memory
+	void Reset();
+
+	// Vertices in the winding the caller wants, Normal is the outward normal of the face
+	void AddQuad(const FVector3f& V0, const FVector3f& V1, const FVector3f& V2, const FVector3f& V3,
+	             const FVector2f& UV0, const FVector2f& UV1, const FVector2f& UV2, const FVector2f& UV3,
+	             float TextureIndex, const FVector3f& Normal);
+
+	int32 NumTriangles() const
+	{
+		return Section.ProcIndexBuffer.Num() / 3;
+	}
+
+	bool IsEmpty() const
+	{
+		return Section.ProcIndexBuffer.IsEmpty();
+	}
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return Section.ProcVertexBuffer.GetAllocatedSize() + Section.ProcIndexBuffer.GetAllocatedSize();
+	}
+};
+
+// Collision only mesher output, positions and indices without any render attribute
+struct BLUEVOX_API FChunkCollisionStream
+{
+	TArray<FVector3f> Positions;
+
+	TArray<uint32> Indices;
+
+	void Reserve(const int32 NumQuads)
+	{
+		Positions.Reserve(NumQuads * 4);
+		Indices.Reserve(NumQuads * 6);
+	}
+
+	void Reset()
+	{
+		Positions.Reset();
+		Indices.Reset();
+	}
+
+	void AddQuad(const FVector3f& V0, const FVector3f& V1, const FVector3f& V2, const FVector3f& V3)
+	{
+		const uint32 First = Positions.Num();
+		Positions.Append({V0, V1, V2, V3});
+		Indices.Append({First, First + 1, First + 2, First, First + 2, First + 3});
+	}
+
+	int32 NumTriangles() const
+	{
+		return Indices.Num() / 3;
+	}
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return Positions.GetAllocatedSize() + Indices.GetAllocatedSize();
+	}
+};
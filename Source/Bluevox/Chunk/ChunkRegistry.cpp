@@ -7,7 +7,10 @@
 #include "LogChunk.h"
 #include "RegionFile.h"
 #include "Bluevox/Game/GameManager.h"
+#include "Bluevox/Utils/Face.h"
 #include "Data/ChunkData.h"
+#include "Data/ChunkEditBatch.h"
+#include "Position/ColumnPosition.h"
 #include "Position/LocalChunkPosition.h"
 #include "Position/LocalPosition.h"
 #include "VirtualMap/ChunkTaskManager.h"
@@ -85,16 +88,30 @@ AChunk* UChunkRegistry::SpawnChunk(const FChunkPosition Position)
 	return Chunk;
 }
 
-FChunkColumn& UChunkRegistry::Th_GetColumn(const FColumnPosition& GlobalColPosition)
+bool UChunkRegistry::Th_GetRenderSnapshots(const FChunkPosition& Position, FRenderSnapshots& OutSnapshots)
 {
 	FReadScopeLock Lock(ChunksDataLock);
-	const FChunkPosition ChunkPos = FChunkPosition::FromColumnPosition(GlobalColPosition);
-	const FLocalColumnPosition LocalColPosition = FLocalColumnPosition::FromColumnPosition(GlobalColPosition);
 
-	checkf(ChunksData.Contains(ChunkPos),
-		   TEXT("Chunk column not found for position %s"), *GlobalColPosition.ToString());
+	FChunkData* Center = ChunkDataStore.Get(ChunksData.FindRef(Position));
+	if (!Center)
+	{
+		return false;
+	}
+	OutSnapshots.Center = Center->Th_GetSnapshot();
+
+	for (const EFace Face : FaceUtils::AllHorizontalFaces)
+	{
+		const FIntVector2 Offset = FaceUtils::GetHorizontalOffsetByFace(Face);
+		FChunkData* Neighbor = ChunkDataStore.Get(ChunksData.FindRef(Position + FChunkPosition{Offset.X, Offset.Y}));
+		if (!Neighbor)
+		{
+			UE_LOG(LogChunk, Warning, TEXT("Missing neighbor data to render chunk %s"), *Position.ToString());
+			return false;
+		}
+		OutSnapshots.Neighbors[static_cast<uint8>(Face)] = Neighbor->Th_GetSnapshot();
+	}
 
-	return ChunksData[ChunkPos]->GetColumn(LocalColPosition);
+	return true;
 }
 
 void UChunkRegistry::SetPiece(const FGlobalPosition& GlobalPosition, FPiece&& InPiece)
@@ -106,16 +123,11 @@ void UChunkRegistry::SetPiece(const FGlobalPosition& GlobalPosition, FPiece&& In
 	TArray<uint16> RemovedPiecesZ;
 	TPair<TOptional<FChangeFromSet>, TOptional<FChangeFromSet>> ChangedPieces;
 	ChunkData->Th_SetPiece(LocalPosition.X, LocalPosition.Y, LocalPosition.Z, MoveTemp(InPiece), RemovedPiecesZ, ChangedPieces);
-	
-	GameManager->ChunkTaskManager->ScheduleRender({ ChunkPosition });
 
-	TArray<FChunkPosition> NeighborsToRender;
-	GlobalPosition.GetBorderChunks(NeighborsToRender);
-	if (NeighborsToRender.Num() > 0)
-	{
-		const TSet<FChunkPosition> UniqueNeighborsToRender = TSet(NeighborsToRender);
-		GameManager->ChunkTaskManager->ScheduleRenderForced(UniqueNeighborsToRender);
-	}
+	TSet<FChunkPosition> ChunksToRender = { ChunkPosition };
+	MarkNeighborColumnsDirty(FColumnPosition(GlobalPosition.X, GlobalPosition.Y), ChunksToRender);
+
+	GameManager->ChunkTaskManager->ScheduleRender(ChunksToRender);
 }
 
 void UChunkRegistry::SetPiece(const FGlobalPosition& GlobalPosition, const FPiece& Piece)
@@ -124,6 +136,66 @@ void UChunkRegistry::SetPiece(const FGlobalPosition& GlobalPosition, const FPiec
 	SetPiece(GlobalPosition, MoveTemp(PieceCopy));
 }
 
+void UChunkRegistry::SetPieces(const FChunkEditBatch& Batch)
+{
+	TSet<FChunkPosition> ChunksToRender;
+	const int32 Size = GameConstants::Chunk::Size;
+
+	for (const auto& [ChunkPosition, Edits] : Batch.GetChunks())
+	{
+		FChunkData* ChunkData = Th_GetChunkData(ChunkPosition);
+		if (!ChunkData)
+		{
+			UE_LOG(LogChunk, Warning, TEXT("SetPieces: Chunk %s is not loaded, skipping its edits"), *ChunkPosition.ToString());
+			continue;
+		}
+
+		ChunkData->Th_ApplyEdits(Edits);
+		ChunksToRender.Add(ChunkPosition);
+
+		for (const auto& [ColIndex, ColumnEdits] : Edits.Columns)
+		{
+			const int32 LocalX = ColIndex % Size;
+			const int32 LocalY = ColIndex / Size;
+			if (LocalX == 0 || LocalY == 0 || LocalX == Size - 1 || LocalY == Size - 1)
+			{
+				MarkNeighborColumnsDirty(FColumnPosition(ChunkPosition.X * Size + LocalX, ChunkPosition.Y * Size + LocalY), ChunksToRender);
+			}
+		}
+	}
+
+	if (ChunksToRender.Num() > 0)
+	{
+		GameManager->ChunkTaskManager->ScheduleRender(ChunksToRender);
+	}
+}
+
+void UChunkRegistry::MarkNeighborColumnsDirty(const FColumnPosition& GlobalColumn, TSet<FChunkPosition>& OutNeighbors)
+{
+	const FChunkPosition ChunkPosition = FChunkPosition::FromColumnPosition(GlobalColumn);
+	for (const EFace Face : FaceUtils::AllHorizontalFaces)
+	{
+		const FIntVector2 Offset = FaceUtils::GetHorizontalOffsetByFace(Face);
+		const FColumnPosition NeighborColumn(GlobalColumn.X + Offset.X, GlobalColumn.Y + Offset.Y);
+		const FChunkPosition NeighborPosition = FChunkPosition::FromColumnPosition(NeighborColumn);
+		if (NeighborPosition == ChunkPosition)
+		{
+			continue;
+		}
+
+		FChunkData* NeighborData = Th_GetChunkData(NeighborPosition);
+		if (!NeighborData)
+		{
+			continue;
+		}
+
+		// Only its column facing the edit has side faces to add or drop
+		const FLocalColumnPosition LocalColumn = FLocalColumnPosition::FromColumnPosition(NeighborColumn);
+		NeighborData->Th_MarkColumnDirty(FChunkData::GetIndex(LocalColumn));
+		OutNeighbors.Add(NeighborPosition);
+	}
+}
+
 void UChunkRegistry::Th_UnregisterChunk(const FChunkPosition& Position)
 {
 	UE_LOG(LogChunk, Verbose, TEXT("Unregistering chunk at position %s"), *Position.ToString());
@@ -148,14 +220,24 @@ void UChunkRegistry::Th_UnregisterChunk(const FChunkPosition& Position)
 		ChunkActors.Remove(Position);
 	}
 
+	bool bRemoved = false;
 	{
 		FWriteScopeLock Lock(ChunksDataLock);
-		if (ChunksData.Contains(Position))
+		FChunkDataHandle Handle;
+		bRemoved = ChunksData.RemoveAndCopyValue(Position, Handle);
+		if (bRemoved)
 		{
-			ChunksData.Remove(Position);
+			// May run on a worker, the game thread can still be using it
+			ReleasedChunksData.Add(Handle);
 		}
 	}
 
+	// Evicted chunks were already taken out of their region
+	if (!bRemoved || !bServer)
+	{
+		return;
+	}
+
 	const auto RegionPosition = FRegionPosition::FromChunkPosition(Position);
 	{
 		FWriteScopeLock Lock(RegionsLock);
@@ -169,7 +251,7 @@ void UChunkRegistry::Th_UnregisterChunk(const FChunkPosition& Position)
 	}
 }
 
-void UChunkRegistry::LockForRender(const FChunkPosition& Position)
+void UChunkRegistry::MarkForRender(const FChunkPosition& Position)
 {
 	static const std::array Offsets = {
 		FChunkPosition{0, 0},
@@ -178,32 +260,19 @@ void UChunkRegistry::LockForRender(const FChunkPosition& Position)
 		FChunkPosition{1, 0},
 		FChunkPosition{-1, 0}
 	};
-	
-	{
-		FReadScopeLock Lock(ChunksDataLock);
-
-		for (const auto& Offset : Offsets)
-		{
-			ChunksData.FindRef(Position + Offset)->Lock.ReadLock();
-		}
-	}
 
+	FScopeLock ScopeLock(&ChunksMarkedForUseLock);
+	for (const auto& Offset : Offsets)
 	{
-		FScopeLock ScopeLock(&ChunksMarkedForUseLock);
-		for (const auto& Offset : Offsets)
-		{
-			ChunksMarkedForUse.FindOrAdd(Position + Offset) += 1;
-		}
+		ChunksMarkedForUse.FindOrAdd(Position + Offset) += 1;
 	}
 }
 
-void UChunkRegistry::UnlockForRender(const FChunkPosition& Position)
+void UChunkRegistry::UnmarkForRender(const FChunkPosition& Position)
 {
 	TArray<FChunkPosition> RemoveChunksMarkedForUse;
 
 	{
-		FReadScopeLock Lock(ChunksDataLock);
-	
 		static const std::array Offsets = {
 			FChunkPosition{0, 0},
 			FChunkPosition{0, 1},
@@ -215,7 +284,6 @@ void UChunkRegistry::UnlockForRender(const FChunkPosition& Position)
 		FScopeLock ScopeLock(&ChunksMarkedForUseLock);
 		for (const auto& Offset : Offsets)
 		{
-			ChunksData.FindRef(Position + Offset)->Lock.ReadUnlock();
 			if (ChunksMarkedForUse.Contains(Position + Offset))
 			{
 				auto& AmountMarkedForUse = *ChunksMarkedForUse.Find(Position + Offset);
@@ -243,31 +311,70 @@ void UChunkRegistry::UnlockForRender(const FChunkPosition& Position)
 	}
 }
 
-UChunkData* UChunkRegistry::Th_GetChunkData(const FChunkPosition& Position)
+FChunkData* UChunkRegistry::Th_GetChunkData(const FChunkPosition& Position)
 {
 	FReadScopeLock Lock(ChunksDataLock);
-	return ChunksData.FindRef(Position);
+	return ChunkDataStore.Get(ChunksData.FindRef(Position));
 }
 
-void UChunkRegistry::Th_RegisterChunk(const FChunkPosition& Position, UChunkData* Data)
+void UChunkRegistry::FreeReleasedChunksData()
+{
+	TArray<FChunkDataHandle> ToFree;
+	{
+		FWriteScopeLock Lock(ChunksDataLock);
+		if (ReleasedChunksData.IsEmpty())
+		{
+			return;
+		}
+		ToFree = MoveTemp(ReleasedChunksData);
+	}
+
+	for (const FChunkDataHandle Handle : ToFree)
+	{
+		ChunkDataStore.Free(Handle);
+	}
+}
+
+FChunkData* UChunkRegistry::Th_RegisterChunk(const FChunkPosition& Position,
+                                             const TSharedRef<const FChunkColumnStorage, ESPMode::ThreadSafe>& Columns,
+                                             TArray<FEntityRecord>&& Entities)
 {
 	UE_LOG(LogChunk, Verbose, TEXT("Registering chunk data for position %s"), *Position.ToString());
-	FWriteScopeLock Lock(ChunksDataLock);
 
-	if (!ChunksData.Contains(Position) && bServer)
+	// Initialized outside of the lock, nobody can reach it before it is in ChunksData
+	const FChunkDataHandle Handle = ChunkDataStore.Allocate();
+	FChunkData* Data = ChunkDataStore.Get(Handle)->Init(GameManager, Position, Columns, MoveTemp(Entities));
+
 	{
-		LoadedByRegion.FindOrAdd(FRegionPosition::FromChunkPosition(Position)) += 1;
+		FWriteScopeLock Lock(ChunksDataLock);
+
+		if (const FChunkDataHandle* Previous = ChunksData.Find(Position))
+		{
+			ReleasedChunksData.Add(*Previous);
+		}
+		else if (bServer)
+		{
+			LoadedByRegion.FindOrAdd(FRegionPosition::FromChunkPosition(Position)) += 1;
+		}
+
+		{
+			FScopeLock ScopeLock(&ChunksMarkedForUseLock);
+			ChunksScheduledToRemove.Remove(Position);
+		}
+		ChunksData.Add(Position, Handle);
 	}
 
+	// Still spawned for the data it replaces, which is freed once nothing points to it
+	if (AChunk* const* ChunkActor = ChunkActors.Find(Position); ChunkActor && *ChunkActor)
 	{
-		FScopeLock ScopeLock(&ChunksMarkedForUseLock);
-		ChunksScheduledToRemove.Remove(Position);
+		(*ChunkActor)->ChunkData = Data;
 	}
-	ChunksData.Add(Position, Data);
+
+	return Data;
 }
 
 // TODO if used in other places, may cause to have unused RegionFiles
-bool UChunkRegistry::Th_FetchChunkDataFromDisk(const FChunkPosition& Position, TArray<FChunkColumn>& OutColumns,
+bool UChunkRegistry::Th_FetchChunkDataFromDisk(const FChunkPosition& Position, FChunkColumnStorage& OutColumns,
                                                 TArray<FEntityRecord>& OutEntities)
 {
 	UE_LOG(LogChunk, Verbose, TEXT("Fetching chunk data from disk for position %s"), *Position.ToString());
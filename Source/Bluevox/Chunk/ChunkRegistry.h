@@ -7,15 +7,18 @@
 #include "Position/ChunkPosition.h"
 #include "UObject/Object.h"
 #include "Bluevox/Entity/EntityTypes.h"
+#include "Data/ChunkDataStore.h"
 #include "ChunkRegistry.generated.h"
 
 struct FPiece;
 struct FColumnPosition;
-struct FChunkColumn;
+struct FChunkColumnStorage;
+struct FRenderSnapshots;
+struct FChunkEditBatch;
 class UWorldSave;
 class AGameManager;
 struct FRegionFile;
-class UChunkData;
+class FChunkData;
 class AChunk;
 class URegion;
 
@@ -28,6 +31,7 @@ class BLUEVOX_API UChunkRegistry : public UObject
 	GENERATED_BODY()
 
 	friend class UChunkTaskManager;
+	friend class UChunkResidencyManager;
 	
 	TMap<FRegionPosition, TSharedPtr<FRegionFile>> Regions;
 
@@ -42,8 +46,12 @@ class BLUEVOX_API UChunkRegistry : public UObject
 	UPROPERTY()
 	AGameManager* GameManager;
 
-	UPROPERTY()
-	TMap<FChunkPosition, UChunkData*> ChunksData;
+	FChunkDataStore ChunkDataStore;
+
+	TMap<FChunkPosition, FChunkDataHandle> ChunksData;
+
+	// Taken out of ChunksData but not freed yet, the game thread may still hold them this frame. Guarded by ChunksDataLock
+	TArray<FChunkDataHandle> ReleasedChunksData;
 
 	FRWLock ChunksDataLock;
 
@@ -58,8 +66,10 @@ class BLUEVOX_API UChunkRegistry : public UObject
 	UPROPERTY()
 	TSet<FChunkPosition> ChunksScheduledToRemove;
 
-	UFUNCTION()
-	void Th_RegisterChunk(const FChunkPosition& Position, UChunkData* Data);
+	// Creates the chunk data in the store, replacing any registered at the same position
+	FChunkData* Th_RegisterChunk(const FChunkPosition& Position,
+	                             const TSharedRef<const FChunkColumnStorage, ESPMode::ThreadSafe>& Columns,
+	                             TArray<FEntityRecord>&& Entities);
 
 	TSharedPtr<FRegionFile> Th_LoadRegionFile(const FRegionPosition& Position);
 	
@@ -67,27 +77,37 @@ class BLUEVOX_API UChunkRegistry : public UObject
 
 	AChunk* SpawnChunk(FChunkPosition Position);
 
-	void LockForRender(const FChunkPosition& Position);
+	// Keeps the chunk and its neighbors registered until the render is done, nothing is locked
+	void MarkForRender(const FChunkPosition& Position);
+
+	void UnmarkForRender(const FChunkPosition& Position);
 
-	void UnlockForRender(const FChunkPosition& Position);
+	// Marks the columns of other chunks touching GlobalColumn as dirty, adding those chunks to OutNeighbors
+	void MarkNeighborColumnsDirty(const FColumnPosition& GlobalColumn, TSet<FChunkPosition>& OutNeighbors);
 	
 public:
 	UChunkRegistry* Init(AGameManager* InGameManager);
 
 	TSharedPtr<FRegionFile> Th_GetRegionFile(const FRegionPosition& Position);
 
-	FChunkColumn& Th_GetColumn(const FColumnPosition& GlobalColPosition);
+	// Snapshots of a chunk and its 4 horizontal neighbors, false if any of them isn't loaded
+	bool Th_GetRenderSnapshots(const FChunkPosition& Position, FRenderSnapshots& OutSnapshots);
 
 	void SetPiece(const FGlobalPosition& GlobalPosition, FPiece&& InPiece);
 
 	void SetPiece(const FGlobalPosition& GlobalPosition, const FPiece& Piece);
 
-	UFUNCTION()
-	UChunkData* Th_GetChunkData(const FChunkPosition& Position);
+	// Applies a whole batch, each touched chunk is rendered once and each affected neighbor invalidated once
+	void SetPieces(const FChunkEditBatch& Batch);
+
+	FChunkData* Th_GetChunkData(const FChunkPosition& Position);
+
+	// Game thread, outside of any parallel tick. Frees the chunk data unregistered or replaced since the last call,
+	// nobody reaches it through the registry or a chunk actor anymore
+	void FreeReleasedChunksData();
 
 	// TODO should not use Th_LoadRegionFile, instead use a Th_GetRegionFile and discard immediately
-	UFUNCTION()
-	bool Th_FetchChunkDataFromDisk(const FChunkPosition& Position, TArray<FChunkColumn>& OutColumns,
+	bool Th_FetchChunkDataFromDisk(const FChunkPosition& Position, FChunkColumnStorage& OutColumns,
 	                                TArray<FEntityRecord>& OutEntities);
 	
 	UFUNCTION()
@@ -101,4 +121,6 @@ public:
 	// Get specific chunk actor
 	UFUNCTION(BlueprintPure, Category = "Chunk")
 	AChunk* GetChunkActor(const FChunkPosition& Position) const;
+
+	const FChunkDataStore& GetChunkDataStore() const { return ChunkDataStore; }
 };
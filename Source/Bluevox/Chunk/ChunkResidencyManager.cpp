@@ -0,0 +1,177 @@
+﻿#include "ChunkResidencyManager.h"
+
+#include "Chunk.h"
+#include "ChunkRegistry.h"
+#include "ChunkStats.h"
+#include "LogChunk.h"
+#include "Data/ChunkData.h"
+#include "VirtualMap/ChunkTaskManager.h"
+#include "VirtualMap/VirtualMap.h"
+#include "Bluevox/Game/GameConstants.h"
+#include "Bluevox/Game/GameManager.h"
+#include "Bluevox/Tick/TickManager.h"
+
+UChunkResidencyManager* UChunkResidencyManager::Init(AGameManager* InGameManager)
+{
+	GameManager = InGameManager;
+	GameManager->TickManager->RegisterUObjectTickable(this);
+	return this;
+}
+
+void UChunkResidencyManager::GameTick(const float DeltaTime)
+{
+	AccumulatedSeconds += DeltaTime;
+	if (AccumulatedSeconds >= GameConstants::Chunk::Residency::IntervalSeconds)
+	{
+		AccumulatedSeconds = 0.0f;
+		Scan();
+	}
+}
+
+void UChunkResidencyManager::Scan()
+{
+	TArray<TPair<FChunkPosition, FChunkData*>> Chunks;
+	{
+		FReadScopeLock Lock(GameManager->ChunkRegistry->ChunksDataLock);
+		Chunks.Reserve(GameManager->ChunkRegistry->ChunksData.Num());
+		for (const auto& Pair : GameManager->ChunkRegistry->ChunksData)
+		{
+			Chunks.Emplace(Pair.Key, GameManager->ChunkRegistry->ChunkDataStore.Get(Pair.Value));
+		}
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	SIZE_T ColumnBytes = 0;
+	SIZE_T EntityBytes = 0;
+	SIZE_T MeshBytes = 0;
+
+	TMap<FChunkPosition, FChunkResidency> NewResidency;
+	NewResidency.Reserve(Chunks.Num());
+	for (const auto& [Position, ChunkData] : Chunks)
+	{
+		FChunkResidency Entry;
+		if (const FChunkResidency* Previous = Residency.Find(Position))
+		{
+			Entry = *Previous;
+		}
+		else
+		{
+			Entry.LastUsedSeconds = Now;
+		}
+
+		const FVirtualChunk* VirtualChunk = GameManager->VirtualMap->VirtualChunks.Find(Position);
+		if (Entry.SeenChanges != ChunkData->Changes || (VirtualChunk && VirtualChunk->LiveForCount > 0))
+		{
+			Entry.LastUsedSeconds = Now;
+			Entry.SeenChanges = ChunkData->Changes;
+		}
+
+		Entry.ColumnBytes = ChunkData->Th_GetColumnsAllocatedSize();
+		{
+			FReadScopeLock ReadLock(ChunkData->Lock);
+			Entry.EntityBytes = ChunkData->GetEntitiesAllocatedSize();
+		}
+		const AChunk* Chunk = GameManager->ChunkRegistry->GetChunkActor(Position);
+		Entry.MeshBytes = Chunk ? Chunk->GetMeshAllocatedSize() : 0;
+
+		ColumnBytes += Entry.ColumnBytes;
+		EntityBytes += Entry.EntityBytes;
+		MeshBytes += Entry.MeshBytes;
+		NewResidency.Add(Position, Entry);
+	}
+
+	Residency = MoveTemp(NewResidency);
+	ResidentBytes = ColumnBytes + EntityBytes + MeshBytes;
+
+	SET_DWORD_STAT(STAT_ChunkResidency_Chunks, Residency.Num());
+	SET_MEMORY_STAT(STAT_ChunkResidency_Total, ResidentBytes);
+	SET_MEMORY_STAT(STAT_ChunkResidency_Columns, ColumnBytes);
+	SET_MEMORY_STAT(STAT_ChunkResidency_Entities, EntityBytes);
+	SET_MEMORY_STAT(STAT_ChunkResidency_Mesh, MeshBytes);
+
+	const SIZE_T BudgetBytes = static_cast<SIZE_T>(FMath::Max(GameConstants::Chunk::Residency::BudgetMB, 0)) * 1024 * 1024;
+	if (BudgetBytes > 0 && ResidentBytes > BudgetBytes)
+	{
+		EvictColdChunks(BudgetBytes);
+	}
+}
+
+void UChunkResidencyManager::EvictColdChunks(const SIZE_T BudgetBytes)
+{
+	const double IdleBefore = FPlatformTime::Seconds() - GameConstants::Chunk::Residency::MinIdleSeconds;
+
+	TArray<FChunkPosition> Candidates;
+	for (const auto& [Position, Entry] : Residency)
+	{
+		if (Entry.LastUsedSeconds <= IdleBefore && CanEvict(Position))
+		{
+			Candidates.Add(Position);
+		}
+	}
+
+	// Least recently used first
+	Candidates.Sort([this](const FChunkPosition& A, const FChunkPosition& B)
+	{
+		return Residency[A].LastUsedSeconds < Residency[B].LastUsedSeconds;
+	});
+
+	TSet<FChunkPosition> ToEvict;
+	for (const FChunkPosition& Position : Candidates)
+	{
+		if (ResidentBytes <= BudgetBytes || ToEvict.Num() >= GameConstants::Chunk::Residency::MaxEvictionsPerScan)
+		{
+			break;
+		}
+
+		const FChunkResidency Entry = Residency.FindAndRemoveChecked(Position);
+		ResidentBytes -= Entry.GetTotalBytes();
+		GameManager->VirtualMap->VirtualChunks[Position].bEvicted = true;
+		ToEvict.Add(Position);
+	}
+
+	if (ToEvict.Num() > 0)
+	{
+		UE_LOG(LogChunk, Verbose, TEXT("Evicting %d cold chunks, %llu bytes resident after it, budget is %llu"),
+			ToEvict.Num(), static_cast<uint64>(ResidentBytes), static_cast<uint64>(BudgetBytes));
+		INC_DWORD_STAT_BY(STAT_ChunkResidency_Evictions, ToEvict.Num());
+		GameManager->ChunkTaskManager->ScheduleUnload(ToEvict);
+	}
+
+	if (ResidentBytes > BudgetBytes && ToEvict.Num() < GameConstants::Chunk::Residency::MaxEvictionsPerScan)
+	{
+		UE_LOG(LogChunk, Warning, TEXT("Chunks take %llu bytes, over the %llu budget, and no load only chunk is left to evict"),
+			static_cast<uint64>(ResidentBytes), static_cast<uint64>(BudgetBytes));
+	}
+}
+
+bool UChunkResidencyManager::CanEvict(const FChunkPosition& Position) const
+{
+	const FVirtualChunk* VirtualChunk = GameManager->VirtualMap->VirtualChunks.Find(Position);
+	if (!VirtualChunk || VirtualChunk->bEvicted || VirtualChunk->LiveForCount > 0 || VirtualChunk->LoadedForCount == 0)
+	{
+		return false;
+	}
+
+	if (GameManager->ChunkTaskManager->IsChunkBusy(Position))
+	{
+		return false;
+	}
+
+	FChunkData* ChunkData = GameManager->ChunkRegistry->Th_GetChunkData(Position);
+	if (!ChunkData)
+	{
+		return false;
+	}
+
+	// Converted entities are backed by facade actors pointing into the chunk
+	FReadScopeLock ReadLock(ChunkData->Lock);
+	for (const FEntityRecord& Entity : ChunkData->Entities)
+	{
+		if (Entity.bIsConvertedToEntity)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,72 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Bluevox/Tick/GameTickable.h"
+#include "Position/ChunkPosition.h"
+#include "UObject/Object.h"
+#include "ChunkResidencyManager.generated.h"
+
+class AGameManager;
+
+struct FChunkResidency
+{
+	SIZE_T ColumnBytes = 0;
+
+	SIZE_T EntityBytes = 0;
+
+	SIZE_T MeshBytes = 0;
+
+	// Last time the chunk was live or edited, in FPlatformTime::Seconds
+	double LastUsedSeconds = 0.0;
+
+	int32 SeenChanges = INDEX_NONE;
+
+	SIZE_T GetTotalBytes() const
+	{
+		return ColumnBytes + EntityBytes + MeshBytes;
+	}
+};
+
+/**
+ * Keeps the memory of the chunks resident on the server under game.chunk.residency.budget_mb.
+ * Every scan measures each registered chunk, and when over budget unloads the least recently used load only chunks,
+ * saving the dirty ones to their region file. Evicted chunks stay in the virtual map and are loaded again as soon
+ * as they are needed, to be rendered next to, to go live or to be sent to a player.
+ */
+UCLASS()
+class BLUEVOX_API UChunkResidencyManager : public UObject, public IGameTickable
+{
+	GENERATED_BODY()
+
+public:
+	UChunkResidencyManager* Init(AGameManager* InGameManager);
+
+	virtual void GameTick(float DeltaTime) override;
+
+	virtual ETickCategory GetTickCategory() const override
+	{
+		return ETickCategory::ChunkResidency;
+	}
+
+	SIZE_T GetResidentBytes() const
+	{
+		return ResidentBytes;
+	}
+
+private:
+	UPROPERTY()
+	AGameManager* GameManager = nullptr;
+
+	TMap<FChunkPosition, FChunkResidency> Residency;
+
+	SIZE_T ResidentBytes = 0;
+
+	float AccumulatedSeconds = 0.0f;
+
+	void Scan();
+
+	// Evicts cold load only chunks until ResidentBytes fits in BudgetBytes
+	void EvictColdChunks(const SIZE_T BudgetBytes);
+
+	bool CanEvict(const FChunkPosition& Position) const;
+};
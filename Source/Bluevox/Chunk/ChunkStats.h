@@ -1,4 +1,4 @@
-#pragma once
+﻿#pragma once
 DECLARE_STATS_GROUP(TEXT("Chunks"), STATGROUP_Chunks, STATCAT_Advanced);
 
 DECLARE_CYCLE_STAT(TEXT("AChunk::BeginRender"), STAT_Chunk_BeginRender, STATGROUP_Chunks);
@@ -9,4 +9,34 @@ DECLARE_CYCLE_STAT(TEXT("ProcessPiece"), STAT_Chunk_BeginRender_ProcessPiece, ST
 
 DECLARE_CYCLE_STAT(TEXT("AllHorizontalFaces"), STAT_Chunk_BeginRender_ProcessPiece_AllHorizontalFaces, STATGROUP_Chunks);
 
-DECLARE_CYCLE_STAT(TEXT("UShape::Render"), STAT_Shape_Render, STATGROUP_Chunks);
\ No newline at end of file
+DECLARE_CYCLE_STAT(TEXT("UShape::Render"), STAT_Shape_Render, STATGROUP_Chunks);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Shared Columns"), STAT_SharedColumns_Unique, STATGROUP_Chunks);
+
+DECLARE_MEMORY_STAT(TEXT("Shared Columns Bytes Saved"), STAT_SharedColumns_BytesSaved, STATGROUP_Chunks);
+
+DECLARE_MEMORY_STAT(TEXT("Shared Columns Overhead"), STAT_SharedColumns_Overhead, STATGROUP_Chunks);
+
+DECLARE_CYCLE_STAT(TEXT("FChunkData::CopyOnWrite"), STAT_ChunkSnapshot_CopyOnWrite, STATGROUP_Chunks);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Snapshot Copies"), STAT_ChunkSnapshot_Copies, STATGROUP_Chunks);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Unlocked Read Fallbacks"), STAT_ChunkData_UnlockedReadFallbacks, STATGROUP_Chunks);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Resident Chunks"), STAT_ChunkResidency_Chunks, STATGROUP_Chunks);
+
+DECLARE_MEMORY_STAT(TEXT("Resident Bytes"), STAT_ChunkResidency_Total, STATGROUP_Chunks);
+
+DECLARE_MEMORY_STAT(TEXT("Resident Column Bytes"), STAT_ChunkResidency_Columns, STATGROUP_Chunks);
+
+DECLARE_MEMORY_STAT(TEXT("Resident Entity Bytes"), STAT_ChunkResidency_Entities, STATGROUP_Chunks);
+
+DECLARE_MEMORY_STAT(TEXT("Resident Mesh Bytes"), STAT_ChunkResidency_Mesh, STATGROUP_Chunks);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Evicted Chunks"), STAT_ChunkResidency_Evictions, STATGROUP_Chunks);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Mesh Cache Hits"), STAT_ChunkMeshCache_Hits, STATGROUP_Chunks);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Mesh Cache Misses"), STAT_ChunkMeshCache_Misses, STATGROUP_Chunks);
+
+DECLARE_MEMORY_STAT(TEXT("Mesh Cache Disk Bytes"), STAT_ChunkMeshCache_Bytes, STATGROUP_Chunks);
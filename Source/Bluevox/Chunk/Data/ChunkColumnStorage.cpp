@@ -0,0 +1,327 @@
+﻿#include "ChunkColumnStorage.h"
+
+#include "SharedColumnTable.h"
+#include "Bluevox/Game/GameConstants.h"
+
+void FChunkColumnStorage::Reset(const int32 InNumColumns, const int32 ReservePieces)
+{
+	Pieces.Reset(ReservePieces);
+	Starts.Reset(ReservePieces);
+	Spans.Reset(InNumColumns);
+	Spans.SetNum(InNumColumns);
+	Palette.Reset();
+	SharedColumns.Reset();
+	LivePieces = 0;
+}
+
+void FChunkColumnStorage::Empty()
+{
+	Pieces.Empty();
+	Starts.Empty();
+	Spans.Empty();
+	Palette.Empty();
+	SharedColumns.Empty();
+	LivePieces = 0;
+}
+
+void FChunkColumnStorage::SetColumn(const int32 ColumnIndex, const TArrayView<const FPiece> InPieces)
+{
+	check(Spans.IsValidIndex(ColumnIndex));
+	check(InPieces.Num() <= MaxLocalCapacity);
+
+	FColumnSpan& Span = Spans[ColumnIndex];
+	const bool bWasShared = Span.IsShared();
+	if (bWasShared)
+	{
+		// Copy on write, the shared column is left untouched for the other chunks
+		SharedColumns.RemoveAt(Span.Offset);
+		Span = FColumnSpan();
+	}
+
+	const int32 NewNum = InPieces.Num();
+	LivePieces += NewNum - Span.Num;
+
+	if (NewNum > Span.Capacity)
+	{
+		// Doesn't fit in its slot anymore: move the column to the end, the old slot becomes dead space.
+		// First fills (generation, loading) are exact, only edited columns get some slack, shared ones being copied too.
+		const int32 Slack = Span.Capacity == 0 && !bWasShared ? 0 : RelocationSlack;
+		const int32 NewCapacity = FMath::Min<int32>(NewNum + Slack, MaxLocalCapacity);
+
+		Span.Offset = Pieces.AddUninitialized(NewCapacity);
+		Starts.AddUninitialized(NewCapacity);
+		Span.Capacity = static_cast<uint16>(NewCapacity);
+	}
+
+	Span.Num = static_cast<uint16>(NewNum);
+	for (int32 PieceIndex = 0; PieceIndex < NewNum; ++PieceIndex)
+	{
+		const FPiece& Piece = InPieces[PieceIndex];
+		checkf(Piece.Size <= FPackedPiece::MaxSize, TEXT("Piece of size %d doesn't fit in a packed piece"), Piece.Size);
+		Pieces[Span.Offset + PieceIndex] = FPackedPiece(Piece.Size, FindOrAddPaletteIndex(Piece.MaterialId));
+	}
+	RebuildStarts(Span);
+
+	CompactIfNeeded();
+}
+
+void FChunkColumnStorage::Compact()
+{
+	TArray<FPackedPiece> Compacted;
+	Compacted.SetNumUninitialized(LivePieces);
+	TArray<uint16> CompactedStarts;
+	CompactedStarts.SetNumUninitialized(LivePieces);
+
+	int32 Offset = 0;
+	for (FColumnSpan& Span : Spans)
+	{
+		if (Span.IsShared())
+		{
+			continue;
+		}
+
+		FMemory::Memcpy(Compacted.GetData() + Offset, Pieces.GetData() + Span.Offset, Span.Num * sizeof(FPackedPiece));
+		FMemory::Memcpy(CompactedStarts.GetData() + Offset, Starts.GetData() + Span.Offset, Span.Num * sizeof(uint16));
+		Span.Offset = Offset;
+		Span.Capacity = Span.Num;
+		Offset += Span.Num;
+	}
+
+	Pieces = MoveTemp(Compacted);
+	Starts = MoveTemp(CompactedStarts);
+}
+
+void FChunkColumnStorage::Intern()
+{
+	if (!GameConstants::Chunk::Dedup::bEnabled)
+	{
+		return;
+	}
+
+	FSharedColumnTable& Table = FSharedColumnTable::Get();
+
+	for (FColumnSpan& Span : Spans)
+	{
+		if (Span.IsShared() || Span.Num == 0 || Span.Num > GameConstants::Chunk::Dedup::MaxPiecesToShare)
+		{
+			continue;
+		}
+
+		const FChunkColumnView Column(Pieces.GetData() + Span.Offset, Starts.GetData() + Span.Offset, Palette.GetData(), Span.Num);
+		FSharedColumnRef Shared = Table.Intern(Column);
+
+		LivePieces -= Span.Num;
+		Span.Num = static_cast<uint16>(Shared->NumPieces);
+		Span.Offset = SharedColumns.Add(MoveTemp(Shared));
+		Span.Capacity = FColumnSpan::SharedCapacity;
+	}
+
+	Compact();
+	if (LivePieces == 0)
+	{
+		Palette.Reset();
+	}
+}
+
+void FChunkColumnStorage::CompactIfNeeded()
+{
+	const int32 DeadPieces = Pieces.Num() - LivePieces;
+	if (DeadPieces > FMath::Max(MinDeadPiecesToCompact, LivePieces / 2))
+	{
+		Compact();
+	}
+}
+
+void FChunkColumnStorage::RebuildStarts(const FColumnSpan& Span)
+{
+	const FPackedPiece* ColumnPieces = Pieces.GetData() + Span.Offset;
+	uint16* ColumnStarts = Starts.GetData() + Span.Offset;
+
+	int32 CurZ = 0;
+	for (int32 PieceIndex = 0; PieceIndex < Span.Num; ++PieceIndex)
+	{
+		ColumnStarts[PieceIndex] = static_cast<uint16>(CurZ);
+		CurZ += ColumnPieces[PieceIndex].GetSize();
+	}
+}
+
+int32 FChunkColumnStorage::FindOrAddPaletteIndex(const EMaterial MaterialId)
+{
+	const int32 Index = Palette.Find(MaterialId);
+	if (Index != INDEX_NONE)
+	{
+		return Index;
+	}
+
+	// Entries are never dropped, a chunk can reference at most every EMaterial once
+	checkf(Palette.Num() < FPackedPiece::MaxPaletteSize,
+		TEXT("EMaterial has more values than a chunk palette can index (%d)"), FPackedPiece::MaxPaletteSize);
+	return Palette.Add(MaterialId);
+}
+
+void FChunkColumnStorage::LoadUnpacked(FArchive& Ar)
+{
+	check(Ar.IsLoading());
+
+	// Checked before reserving anything, the count comes from a file or the network. Anything but a full chunk would
+	// be read out of bounds by the mesher
+	int32 NumColumns = 0;
+	Ar << NumColumns;
+	if (NumColumns != FMath::Square(GameConstants::Chunk::Size))
+	{
+		Ar.SetError();
+		return;
+	}
+
+	Reset(NumColumns, NumColumns * 4);
+
+	TArray<FPiece, TInlineAllocator<64>> ColumnPieces;
+	for (int32 ColumnIndex = 0; ColumnIndex < NumColumns && !Ar.IsError(); ++ColumnIndex)
+	{
+		int32 NumPieces = 0;
+		Ar << NumPieces;
+		if (NumPieces < 0 || NumPieces > MaxLocalCapacity)
+		{
+			Ar.SetError();
+			break;
+		}
+
+		int32 Height = 0;
+		ColumnPieces.SetNum(NumPieces);
+		for (FPiece& Piece : ColumnPieces)
+		{
+			Ar << Piece;
+			Height += Piece.Size;
+		}
+		if (Height > GameConstants::Chunk::Height)
+		{
+			Ar.SetError();
+			break;
+		}
+		SetColumn(ColumnIndex, ColumnPieces);
+	}
+}
+
+void FChunkColumnStorage::Load(FArchive& Ar)
+{
+	check(Ar.IsLoading());
+
+	int32 NumPalette = 0;
+	Ar << NumPalette;
+
+	int32 NumColumns = 0;
+	Ar << NumColumns;
+
+	// Checked before reserving anything, see LoadUnpacked
+	if (NumPalette < 0 || NumPalette > FPackedPiece::MaxPaletteSize || NumColumns != FMath::Square(GameConstants::Chunk::Size))
+	{
+		Ar.SetError();
+		return;
+	}
+
+	// Generated columns usually have a handful of pieces, avoids most of the regrowth while reading
+	Reset(NumColumns, NumColumns * 4);
+
+	Palette.SetNum(NumPalette);
+	for (EMaterial& MaterialId : Palette)
+	{
+		Ar << MaterialId;
+	}
+
+	for (int32 ColumnIndex = 0; ColumnIndex < NumColumns && !Ar.IsError(); ++ColumnIndex)
+	{
+		uint16 NumPieces = 0;
+		Ar << NumPieces;
+
+		// SharedCapacity would make it index SharedColumns, no column that long fits in a chunk anyway
+		if (NumPieces > MaxLocalCapacity)
+		{
+			Ar.SetError();
+			return;
+		}
+
+		FColumnSpan& Span = Spans[ColumnIndex];
+		Span.Offset = Pieces.Num();
+		Span.Num = NumPieces;
+		Span.Capacity = NumPieces;
+		LivePieces += NumPieces;
+
+		int32 Height = 0;
+		for (int32 PieceIndex = 0; PieceIndex < NumPieces; ++PieceIndex)
+		{
+			FPackedPiece& Piece = Pieces.AddDefaulted_GetRef();
+			Ar << Piece;
+			Height += Piece.GetSize();
+			if (Piece.GetPaletteIndex() >= NumPalette || Height > GameConstants::Chunk::Height)
+			{
+				Ar.SetError();
+				return;
+			}
+		}
+		Starts.AddUninitialized(NumPieces);
+		RebuildStarts(Span);
+	}
+}
+
+void FChunkColumnStorage::Save(FArchive& Ar) const
+{
+	check(Ar.IsSaving());
+
+	// Shared columns are packed against the identity palette, they are written with the local one plus what they use
+	TArray<EMaterial, TInlineAllocator<FPackedPiece::MaxPaletteSize>> SavePalette = Palette;
+	for (const auto& Shared : SharedColumns)
+	{
+		for (const FPiece Piece : Shared->GetView())
+		{
+			SavePalette.AddUnique(Piece.MaterialId);
+		}
+	}
+
+	int32 NumPalette = SavePalette.Num();
+	Ar << NumPalette;
+
+	int32 NumColumns = Spans.Num();
+	Ar << NumColumns;
+
+	for (EMaterial& MaterialId : SavePalette)
+	{
+		Ar << MaterialId;
+	}
+
+	for (int32 ColumnIndex = 0; ColumnIndex < NumColumns; ++ColumnIndex)
+	{
+		const FColumnSpan& Span = Spans[ColumnIndex];
+		uint16 NumPieces = Span.Num;
+		Ar << NumPieces;
+
+		if (!Span.IsShared())
+		{
+			for (int32 PieceIndex = 0; PieceIndex < Span.Num; ++PieceIndex)
+			{
+				FPackedPiece Packed = Pieces[Span.Offset + PieceIndex];
+				Ar << Packed;
+			}
+			continue;
+		}
+
+		for (const FPiece Piece : GetColumn(ColumnIndex))
+		{
+			FPackedPiece Packed(Piece.Size, SavePalette.Find(Piece.MaterialId));
+			Ar << Packed;
+		}
+	}
+}
+
+FArchive& operator<<(FArchive& Ar, FChunkColumnStorage& Storage)
+{
+	if (Ar.IsLoading())
+	{
+		Storage.Load(Ar);
+	}
+	else
+	{
+		Storage.Save(Ar);
+	}
+
+	return Ar;
+}
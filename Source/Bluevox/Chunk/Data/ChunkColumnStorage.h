@@ -0,0 +1,333 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Piece.h"
+#include "Algo/BinarySearch.h"
+
+/**
+ * FPiece as kept by FChunkColumnStorage, in memory, region files and packets.
+ * The low bits hold the run length and the high bits the index of the material in the chunk palette.
+ */
+struct FPackedPiece
+{
+	static constexpr int32 SizeBits = 11;
+
+	static constexpr uint16 SizeMask = (1 << SizeBits) - 1;
+
+	static constexpr int32 MaxSize = SizeMask;
+
+	static constexpr int32 MaxPaletteSize = 1 << (16 - SizeBits);
+
+	FPackedPiece()
+	{
+	}
+
+	FPackedPiece(const int32 InSize, const int32 InPaletteIndex)
+		: Bits(static_cast<uint16>(InSize | InPaletteIndex << SizeBits))
+	{
+		checkSlow(InSize >= 0 && InSize <= MaxSize);
+		checkSlow(InPaletteIndex >= 0 && InPaletteIndex < MaxPaletteSize);
+	}
+
+	int32 GetSize() const
+	{
+		return Bits & SizeMask;
+	}
+
+	int32 GetPaletteIndex() const
+	{
+		return Bits >> SizeBits;
+	}
+
+	uint16 Bits = 0;
+
+	friend FArchive& operator<<(FArchive& Ar, FPackedPiece& Piece)
+	{
+		Ar << Piece.Bits;
+		return Ar;
+	}
+};
+
+static_assert(sizeof(FPackedPiece) == 2, "FPackedPiece must stay 16 bits");
+
+/**
+ * Read-only view over the pieces of a single column, ordered from Z = 0 upwards.
+ * Pieces are decoded on access and returned by value, so callers never see the packed layout.
+ * Every piece also has its cumulative start, so height lookups are binary searches instead of a walk from Z = 0.
+ */
+struct FChunkColumnView
+{
+	struct FIterator
+	{
+		FIterator(const FPackedPiece* InPtr, const EMaterial* InPalette)
+			: Ptr(InPtr), Palette(InPalette)
+		{
+		}
+
+		FPiece operator*() const
+		{
+			return FPiece(Palette[Ptr->GetPaletteIndex()], static_cast<uint16>(Ptr->GetSize()));
+		}
+
+		FIterator& operator++()
+		{
+			++Ptr;
+			return *this;
+		}
+
+		bool operator!=(const FIterator& Other) const
+		{
+			return Ptr != Other.Ptr;
+		}
+
+	private:
+		const FPackedPiece* Ptr;
+
+		const EMaterial* Palette;
+	};
+
+	FChunkColumnView()
+	{
+	}
+
+	FChunkColumnView(const FPackedPiece* InData, const uint16* InStarts, const EMaterial* InPalette, const int32 InNum)
+		: Data(InData), Starts(InStarts), Palette(InPalette), NumPieces(InNum)
+	{
+	}
+
+	int32 Num() const
+	{
+		return NumPieces;
+	}
+
+	bool IsEmpty() const
+	{
+		return NumPieces == 0;
+	}
+
+	bool IsValidIndex(const int32 Index) const
+	{
+		return Index >= 0 && Index < NumPieces;
+	}
+
+	FPiece operator[](const int32 Index) const
+	{
+		checkSlow(IsValidIndex(Index));
+		return FPiece(Palette[Data[Index].GetPaletteIndex()], static_cast<uint16>(Data[Index].GetSize()));
+	}
+
+	/** Z of the first layer of the piece. */
+	int32 GetStart(const int32 Index) const
+	{
+		checkSlow(IsValidIndex(Index));
+		return Starts[Index];
+	}
+
+	/** Z right above the last layer of the piece. */
+	int32 GetEnd(const int32 Index) const
+	{
+		checkSlow(IsValidIndex(Index));
+		return Starts[Index] + Data[Index].GetSize();
+	}
+
+	/** Sum of the sizes of every piece in the column. */
+	int32 GetHeight() const
+	{
+		return NumPieces == 0 ? 0 : GetEnd(NumPieces - 1);
+	}
+
+	/** Index of the piece containing Z, INDEX_NONE when Z is outside the column. */
+	int32 FindPieceIndex(const int32 Z) const
+	{
+		if (Z < 0 || Z >= GetHeight())
+		{
+			return INDEX_NONE;
+		}
+
+		// Last piece starting at or below Z
+		return Algo::UpperBound(TArrayView<const uint16>(Starts, NumPieces), Z) - 1;
+	}
+
+	FIterator begin() const { return FIterator(Data, Palette); }
+	FIterator end() const { return FIterator(Data + NumPieces, Palette); }
+
+private:
+	const FPackedPiece* Data = nullptr;
+
+	const uint16* Starts = nullptr;
+
+	const EMaterial* Palette = nullptr;
+
+	int32 NumPieces = 0;
+};
+
+/**
+ * Immutable column shared between chunks through FSharedColumnTable.
+ * Pieces are packed against the identity palette (palette index == EMaterial), so any chunk can point to it.
+ */
+struct BLUEVOX_API FSharedColumn
+{
+	FSharedColumn(const uint32 InHash, const FChunkColumnView& Column);
+
+	uint32 Hash = 0;
+
+	int32 NumPieces = 0;
+
+	// Packed pieces followed by their starts, generated columns fit inline
+	TArray<uint16, TInlineAllocator<8>> Buffer;
+
+	FChunkColumnView GetView() const
+	{
+		return FChunkColumnView(reinterpret_cast<const FPackedPiece*>(Buffer.GetData()), Buffer.GetData() + NumPieces,
+			GetIdentityPalette(), NumPieces);
+	}
+
+	bool Equals(const FChunkColumnView& Column) const;
+
+	/** Bytes a chunk would need to hold this column itself. */
+	SIZE_T GetPayloadSize() const
+	{
+		return NumPieces * (sizeof(FPackedPiece) + sizeof(uint16));
+	}
+
+	static uint32 HashColumn(const FChunkColumnView& Column);
+
+	static const EMaterial* GetIdentityPalette();
+};
+
+using FSharedColumnRef = TSharedRef<const FSharedColumn, ESPMode::ThreadSafe>;
+
+/**
+ * Location of a column inside FChunkColumnStorage::Pieces.
+ * Capacity is the number of slots reserved for the column, edits that fit in it are written in place.
+ * Shared columns have Capacity == SharedCapacity and Offset is their index in FChunkColumnStorage::SharedColumns.
+ */
+struct FColumnSpan
+{
+	static constexpr uint16 SharedCapacity = MAX_uint16;
+
+	bool IsShared() const
+	{
+		return Capacity == SharedCapacity;
+	}
+
+	int32 Offset = 0;
+
+	uint16 Num = 0;
+
+	uint16 Capacity = 0;
+};
+
+/**
+ * Piece storage for all the columns of a chunk.
+ * Every piece lives in a single contiguous buffer addressed through a per-column offset/length table, so a
+ * chunk costs two allocations instead of one per column. Columns that outgrow their slot are moved to the end
+ * of the buffer, and the buffer is compacted back into column order once the dead space gets too large.
+ * Pieces are packed into 16 bits against a per-chunk material palette, FChunkColumnView decodes them back.
+ * Starts runs parallel to Pieces and holds the cumulative start of each piece, refreshed whenever a column is written.
+ * After Intern, columns can instead point to an immutable FSharedColumn; writing such a column copies it back locally.
+ */
+struct BLUEVOX_API FChunkColumnStorage
+{
+	FChunkColumnStorage()
+	{
+	}
+
+	explicit FChunkColumnStorage(const int32 InNumColumns)
+	{
+		Reset(InNumColumns);
+	}
+
+	/** Drops every piece and leaves InNumColumns empty columns. */
+	void Reset(const int32 InNumColumns, const int32 ReservePieces = 0);
+
+	void Empty();
+
+	int32 NumColumns() const
+	{
+		return Spans.Num();
+	}
+
+	bool IsValidColumnIndex(const int32 ColumnIndex) const
+	{
+		return Spans.IsValidIndex(ColumnIndex);
+	}
+
+	FChunkColumnView GetColumn(const int32 ColumnIndex) const
+	{
+		const FColumnSpan& Span = Spans[ColumnIndex];
+		if (Span.IsShared())
+		{
+			return SharedColumns[Span.Offset]->GetView();
+		}
+
+		return FChunkColumnView(Pieces.GetData() + Span.Offset, Starts.GetData() + Span.Offset, Palette.GetData(), Span.Num);
+	}
+
+	/**
+	 * Replaces local columns by their shared copy from FSharedColumnTable, adding the ones that aren't there yet.
+	 * Meant to run once a chunk is generated or loaded, before it's registered.
+	 */
+	void Intern();
+
+	/** Replaces the pieces of a column, reusing its slot when possible. */
+	void SetColumn(const int32 ColumnIndex, TArrayView<const FPiece> InPieces);
+
+	void SetColumn(const int32 ColumnIndex, std::initializer_list<FPiece> InPieces)
+	{
+		SetColumn(ColumnIndex, MakeArrayView(InPieces.begin(), static_cast<int32>(InPieces.size())));
+	}
+
+	/** Rewrites the buffer in column order without any slack. */
+	void Compact();
+
+	/** Number of pieces in local columns, excluding shared columns, slack and dead space. */
+	int32 GetNumLivePieces() const
+	{
+		return LivePieces;
+	}
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return Pieces.GetAllocatedSize() + Starts.GetAllocatedSize() + Spans.GetAllocatedSize() + Palette.GetAllocatedSize()
+			+ SharedColumns.GetAllocatedSize();
+	}
+
+	/** Reads the unpacked layout written before chunk FileVersion 2, an array of columns of FPiece. */
+	void LoadUnpacked(FArchive& Ar);
+
+	void Load(FArchive& Ar);
+
+	/** Const counterpart of operator<< for saving, snapshots only hand out const storages. */
+	void Save(FArchive& Ar) const;
+
+	friend BLUEVOX_API FArchive& operator<<(FArchive& Ar, FChunkColumnStorage& Storage);
+
+private:
+	// Extra slots given to a column when it has to be moved, so the following edits can be done in place
+	static constexpr int32 RelocationSlack = 2;
+
+	// Dead space is only reclaimed above this amount, avoids compacting on every edit of small chunks
+	static constexpr int32 MinDeadPiecesToCompact = 256;
+
+	// Relocated columns never reach SharedCapacity, which marks shared spans
+	static constexpr int32 MaxLocalCapacity = FColumnSpan::SharedCapacity - 1;
+
+	void CompactIfNeeded();
+
+	void RebuildStarts(const FColumnSpan& Span);
+
+	int32 FindOrAddPaletteIndex(const EMaterial MaterialId);
+
+	TArray<FPackedPiece> Pieces;
+
+	TArray<uint16> Starts;
+
+	TArray<FColumnSpan> Spans;
+
+	TArray<EMaterial, TInlineAllocator<FPackedPiece::MaxPaletteSize>> Palette;
+
+	TSparseArray<TSharedPtr<const FSharedColumn, ESPMode::ThreadSafe>> SharedColumns;
+
+	int32 LivePieces = 0;
+};
@@ -3,19 +3,21 @@
 
 #include "ChunkData.h"
 
+#include "ChunkEditBatch.h"
 #include "PieceWithStart.h"
+#include "Bluevox/Chunk/ChunkStats.h"
 #include "Bluevox/Chunk/LogChunk.h"
 #include "Bluevox/Chunk/Position/GlobalPosition.h"
-#include "Bluevox/Tick/TickManager.h"
 #include "Bluevox/Inventory/ItemWorldActor.h"
 
-UChunkData* UChunkData::Init(AGameManager* InGameManager, const FChunkPosition InPosition,
-	TArray<FChunkColumn>&& InColumns,
+FChunkData* FChunkData::Init(AGameManager* InGameManager, const FChunkPosition InPosition,
+	const TSharedRef<const FChunkColumnStorage, ESPMode::ThreadSafe>& InColumns,
 	TArray<FEntityRecord>&& InEntities)
 {
 	GameManager = InGameManager;
 	Position = InPosition;
-	Columns = MoveTemp(InColumns);
+	Columns = InColumns;
+	DirtyColumns.Init(true, GameConstants::Chunk::Size * GameConstants::Chunk::Size);
 
 	// Populate sparse array with provided entities maintaining indices
 	Entities.Empty();
@@ -26,18 +28,126 @@ UChunkData* UChunkData::Init(AGameManager* InGameManager, const FChunkPosition I
 		if (!Entities.IsValidIndex(NewIdx)) { /* no-op */ }
 	}
 
-	GameManager->TickManager->RegisterUObjectTickable(this);
-
 	return this;
 }
 
-void UChunkData::SerializeForSave(FArchive& Ar)
+FChunkSnapshot FChunkData::Th_GetSnapshot()
+{
+	FReadScopeLock ReadLock(Lock);
+	return FChunkSnapshot(Position, Columns, Changes);
+}
+
+FChunkColumnStorage& FChunkData::GetMutableColumns()
+{
+	if (!Columns.IsUnique())
+	{
+		// Readers keep the storage they got, the chunk moves on with its own copy
+		SCOPE_CYCLE_COUNTER(STAT_ChunkSnapshot_CopyOnWrite);
+		INC_DWORD_STAT(STAT_ChunkSnapshot_Copies);
+		Columns = MakeShared<FChunkColumnStorage, ESPMode::ThreadSafe>(*Columns);
+	}
+
+	// Nobody else references it anymore, so nobody can see the write
+	return const_cast<FChunkColumnStorage&>(*Columns);
+}
+
+void FChunkData::Th_MarkColumnDirty(const int32 ColIndex)
+{
+	FWriteScopeLock WriteLock(Lock);
+	DirtyColumns[ColIndex] = true;
+}
+
+void FChunkData::Th_TakeDirtyColumns(TBitArray<>& OutDirtyColumns)
+{
+	FWriteScopeLock WriteLock(Lock);
+	OutDirtyColumns = MoveTemp(DirtyColumns);
+	DirtyColumns.Init(false, OutDirtyColumns.Num());
+}
+
+FChunkData::FColumnsWriteScope::FColumnsWriteScope(FChunkData& InChunkData)
+	: ChunkData(InChunkData), WriteLock(InChunkData.Lock)
+{
+	// Readers coming after this see an odd sequence and take the lock without counting themselves, so the wait is
+	// only for the reads already in, a handful of loads each, however many readers keep arriving
+	ChunkData.ColumnsSequence.fetch_add(1);
+	while (ChunkData.UnlockedReaders.load() != 0)
+	{
+		FPlatformProcess::Yield();
+	}
+}
+
+FChunkData::FColumnsWriteScope::~FColumnsWriteScope()
+{
+	ChunkData.ColumnsSequence.fetch_add(1);
+}
+
+template <typename FuncType>
+void FChunkData::Th_ReadColumns(FuncType&& Read)
 {
+	// Entity conversions and other holders of the write lock that leave the columns alone don't get in the way.
+	// Counted in before checking the sequence again: either the write sees this reader and waits for it, or this
+	// reader sees the write and takes the lock. Both are sequentially consistent, they can't miss each other
+	const uint32 Sequence = ColumnsSequence.load();
+	if ((Sequence & 1) == 0)
+	{
+		UnlockedReaders.fetch_add(1);
+		if (ColumnsSequence.load() == Sequence)
+		{
+			Read(*Columns);
+			UnlockedReaders.fetch_sub(1);
+			return;
+		}
+		UnlockedReaders.fetch_sub(1);
+	}
+
+	// A column write is going on, the read lock waits for it
+	INC_DWORD_STAT(STAT_ChunkData_UnlockedReadFallbacks);
 	FReadScopeLock ReadLock(Lock);
+	Read(*Columns);
+}
+
+SIZE_T FChunkData::Th_GetColumnsAllocatedSize()
+{
+	return Th_GetSnapshot().Columns->GetAllocatedSize();
+}
+
+TArray<FEntityRecord> FChunkData::GetEntityRecords() const
+{
+	TArray<FEntityRecord> EntitiesArray;
+	EntitiesArray.Reserve(Entities.Num());
+	for (const FEntityRecord& Rec : Entities)
+	{
+		EntitiesArray.Add(Rec);
+	}
+
+	return EntitiesArray;
+}
+
+void FChunkData::SerializeForSave(FArchive& Ar)
+{
 	int32 FileVersion = GameConstants::Chunk::File::FileVersion;
 
-	Ar << FileVersion;
-	Ar << Columns;
+	if (Ar.IsLoading())
+	{
+		FColumnsWriteScope WriteScope(*this);
+		Ar << FileVersion;
+		if (FileVersion < 2)
+		{
+			GetMutableColumns().LoadUnpacked(Ar);
+		}
+		else
+		{
+			GetMutableColumns().Load(Ar);
+		}
+		DirtyColumns.SetRange(0, DirtyColumns.Num(), true);
+		Changes++;
+	}
+	else
+	{
+		const FChunkSnapshot Snapshot = Th_GetSnapshot();
+		Ar << FileVersion;
+		Snapshot.Columns->Save(Ar);
+	}
 
 	// Serialize world items
 	TArray<FWorldItemData> WorldItems;
@@ -81,243 +191,380 @@ void UChunkData::SerializeForSave(FArchive& Ar)
 	}
 }
 
-void UChunkData::Serialize(FArchive& Ar)
-{
-	FReadScopeLock ReadLock(Lock);
-	UObject::Serialize(Ar);
-	Ar << Columns;
-}
-
-int32 UChunkData::GetFirstGapThatFits(const FGlobalPosition& GlobalPosition,
+int32 FChunkData::GetFirstGapThatFits(const FGlobalPosition& GlobalPosition,
 	const int32 FitHeightInLayers)
 {
 	return GetFirstGapThatFits(GlobalPosition.X, GlobalPosition.Y, FitHeightInLayers);
 }
 
 // TODO in future may have to consider potential caves
-int32 UChunkData::GetFirstGapThatFits(const int32 X, const int32 Y, const int32 FitHeightInLayers)
+int32 FChunkData::GetFirstGapThatFits(const int32 X, const int32 Y, const int32 FitHeightInLayers)
 {
 	const auto Index = GetIndex(X, Y);
-	if (!Columns.IsValidIndex(Index))
+	if (Index < 0 || Index >= GameConstants::Chunk::Size * GameConstants::Chunk::Size)
 	{
 		UE_LOG(LogChunk, Warning, TEXT("GetSurfacePosition: Invalid column index %d for %d,%d"), Index, X, Y);
 		return GameConstants::Chunk::Height;
 	}
 
-	const auto& Column = Columns[Index];
-	if (Column.Pieces.Num() == 0)
+	int32 Result = GameConstants::Chunk::Height;
+	Th_ReadColumns([&](const FChunkColumnStorage& Storage)
 	{
-		return GameConstants::Chunk::Height;
-	}
+		const FChunkColumnView Column = Storage.GetColumn(Index);
+		if (Column.IsEmpty())
+		{
+			Result = GameConstants::Chunk::Height;
+			return;
+		}
 
-	int32 CurZ = 0;
-	for (const auto& Piece : Column.Pieces)
-	{
-		if (Piece.MaterialId == EMaterial::Void && Piece.Size >= FitHeightInLayers)
+		for (int32 PieceIndex = 0; PieceIndex < Column.Num(); ++PieceIndex)
 		{
-			return CurZ;
+			const FPiece Piece = Column[PieceIndex];
+			if (Piece.MaterialId == EMaterial::Void && Piece.Size >= FitHeightInLayers)
+			{
+				Result = Column.GetStart(PieceIndex);
+				return;
+			}
 		}
-		
-		CurZ += Piece.Size;
-	}
 
-	return CurZ;
+		Result = Column.GetHeight();
+	});
+
+	return Result;
 }
 
-bool UChunkData::DoesFit(const FGlobalPosition& GlobalPosition, const int32 FitHeightInLayers) const
+bool FChunkData::DoesFit(const FGlobalPosition& GlobalPosition, const int32 FitHeightInLayers)
 {
 	return DoesFit(GlobalPosition.X, GlobalPosition.Y, GlobalPosition.Z, FitHeightInLayers);
 }
 
-bool UChunkData::DoesFit(const int32 X, const int32 Y, const int32 Z, const int32 FitHeightInLayers) const
+bool FChunkData::DoesFit(const int32 X, const int32 Y, const int32 Z, const int32 FitHeightInLayers)
 {
 	if (FitHeightInLayers <= 0) return false;
 	if (Z < 0) return false;
 
 	const int32 ColIndex = GetIndex(X, Y);
-	if (!Columns.IsValidIndex(ColIndex))
+	if (ColIndex < 0 || ColIndex >= GameConstants::Chunk::Size * GameConstants::Chunk::Size)
 	{
 		UE_LOG(LogChunk, Warning, TEXT("DoesFit: Invalid column index %d for %d,%d"), ColIndex, X, Y);
 		return false;
 	}
 
-	const auto& Column = Columns[ColIndex];
+	bool bFits = false;
+	Th_ReadColumns([&](const FChunkColumnStorage& Storage)
+	{
+		bFits = DoesFitInColumn(Storage.GetColumn(ColIndex), Z, FitHeightInLayers);
+	});
+	return bFits;
+}
+
+void FChunkData::DoesFit(const int32 X, const int32 Y, const TConstArrayView<int32> Zs, const int32 FitHeightInLayers,
+	TBitArray<>& OutFits)
+{
+	OutFits.Init(false, Zs.Num());
+	if (FitHeightInLayers <= 0) return;
 
-	int32 CurZ = 0;
-	for (const auto& Piece : Column.Pieces)
+	const int32 ColIndex = GetIndex(X, Y);
+	if (ColIndex < 0 || ColIndex >= GameConstants::Chunk::Size * GameConstants::Chunk::Size)
 	{
-		const int32 PieceEnd = CurZ + Piece.Size;
+		UE_LOG(LogChunk, Warning, TEXT("DoesFit: Invalid column index %d for %d,%d"), ColIndex, X, Y);
+		return;
+	}
 
-		// Z is inside this piece
-		if (Z < PieceEnd)
+	Th_ReadColumns([&](const FChunkColumnStorage& Storage)
+	{
+		const FChunkColumnView Column = Storage.GetColumn(ColIndex);
+		for (int32 i = 0; i < Zs.Num(); ++i)
 		{
-			if (Piece.MaterialId != EMaterial::Void) return false;
-			const int32 Remaining = PieceEnd - Z;
-			return Remaining >= FitHeightInLayers;
+			OutFits[i] = Zs[i] >= 0 && DoesFitInColumn(Column, Zs[i], FitHeightInLayers);
 		}
-		CurZ = PieceEnd;
+	});
+}
+
+bool FChunkData::DoesFitInColumn(const FChunkColumnView& Column, const int32 Z, const int32 FitHeightInLayers)
+{
+	const int32 PieceIndex = Column.FindPieceIndex(Z);
+	if (PieceIndex == INDEX_NONE)
+	{
+		// Above the last piece
+		return Z + FitHeightInLayers <= GameConstants::Chunk::Height;
 	}
 
-	return Z + FitHeightInLayers <= GameConstants::Chunk::Height;
+	if (Column[PieceIndex].MaterialId != EMaterial::Void) return false;
+	return Column.GetEnd(PieceIndex) - Z >= FitHeightInLayers;
 }
 
-FPieceWithStart UChunkData::Th_GetPieceCopy(const FLocalPosition LocalPosition)
+FPieceWithStart FChunkData::Th_GetPieceCopy(const FLocalPosition LocalPosition)
 {
 	return Th_GetPieceCopy(LocalPosition.X, LocalPosition.Y, LocalPosition.Z);
 }
 
-FPieceWithStart UChunkData::Th_GetPieceCopy(const int32 X, const int32 Y, const int32 Z)
+FPieceWithStart FChunkData::Th_GetPieceCopy(const int32 X, const int32 Y, const int32 Z)
 {
-	FReadScopeLock ReadLock(Lock);
-	
 	const auto ColIndex = GetIndex(X, Y);
-	if (!Columns.IsValidIndex(ColIndex))
+	if (ColIndex < 0 || ColIndex >= GameConstants::Chunk::Size * GameConstants::Chunk::Size)
 	{
 		UE_LOG(LogChunk, Warning, TEXT("GetPieceCopy: Invalid column index %d for %d,%d"), ColIndex, X, Y);
 		return FPieceWithStart();
 	}
 
-	const auto& Column = Columns[ColIndex];
-	int32 CurZ = 0;
-	for (const auto& Piece : Column.Pieces)
+	// Logged once out of the read, nothing else should run while column writes wait on it
+	FPieceWithStart Result;
+	bool bFound = false;
+	Th_ReadColumns([&](const FChunkColumnStorage& Storage)
 	{
-		if (CurZ + Piece.Size >= Z)
-		{
-			return FPieceWithStart(Piece, CurZ);
-		}
+		const FChunkColumnView Column = Storage.GetColumn(ColIndex);
+		const int32 PieceIndex = Column.FindPieceIndex(Z);
+		bFound = PieceIndex != INDEX_NONE;
+		Result = bFound ? FPieceWithStart(Column[PieceIndex], Column.GetStart(PieceIndex)) : FPieceWithStart();
+	});
 
-		CurZ += Piece.Size;
+	if (!bFound)
+	{
+		UE_LOG(LogChunk, Warning, TEXT("GetPieceCopy: No piece found at %d,%d,%d"), X, Y, Z);
 	}
 
-	UE_LOG(LogChunk, Warning, TEXT("GetPieceCopy: No piece found at %d,%d,%d"), X, Y, Z);
-	return FPieceWithStart();
+	return Result;
 }
 
-void UChunkData::Th_SetPiece(const int32 X, const int32 Y, const int32 Z, const FPiece& Piece,
+void FChunkData::Th_GetPieceCopies(const int32 X, const int32 Y, const TConstArrayView<int32> Zs,
+	TArray<FPieceWithStart>& OutPieces)
+{
+	const auto ColIndex = GetIndex(X, Y);
+	if (ColIndex < 0 || ColIndex >= GameConstants::Chunk::Size * GameConstants::Chunk::Size)
+	{
+		UE_LOG(LogChunk, Warning, TEXT("GetPieceCopies: Invalid column index %d for %d,%d"), ColIndex, X, Y);
+		OutPieces.Reset(Zs.Num());
+		OutPieces.SetNum(Zs.Num());
+		return;
+	}
+
+	Th_ReadColumns([&](const FChunkColumnStorage& Storage)
+	{
+		OutPieces.Reset(Zs.Num());
+
+		const FChunkColumnView Column = Storage.GetColumn(ColIndex);
+		for (const int32 Z : Zs)
+		{
+			const int32 PieceIndex = Column.FindPieceIndex(Z);
+			if (PieceIndex == INDEX_NONE)
+			{
+				OutPieces.AddDefaulted();
+				continue;
+			}
+
+			OutPieces.Emplace(Column[PieceIndex], Column.GetStart(PieceIndex));
+		}
+	});
+}
+
+void FChunkData::Th_SetPiece(const int32 X, const int32 Y, const int32 Z, const FPiece& Piece,
 	TArray<uint16>& OutRemovedPiecesZ, TPair<TOptional<FChangeFromSet>, TOptional<FChangeFromSet>>& OutChangedPieces)
 {
-	FWriteScopeLock WriteLock(Lock);
+	FColumnsWriteScope WriteScope(*this);
 	
 	const auto ColIndex = GetIndex(X, Y);
-	if (!Columns.IsValidIndex(ColIndex))
+	if (!Columns->IsValidColumnIndex(ColIndex))
 	{
 		UE_LOG(LogChunk, Warning, TEXT("SetPiece: Invalid column index %d for %d,%d"), ColIndex, X, Y);
 		return;
 	}
 
-	if (Piece.Size <= 0)
+	// Clients send pieces as they like, what the storage can't pack is dropped here
+	if (Z < 0 || Piece.Size <= 0 || Piece.Size > FPackedPiece::MaxSize || !MaterialUtils::IsValid(Piece.MaterialId))
 	{
+		UE_LOG(LogChunk, Warning, TEXT("SetPiece: Invalid piece of size %d and material %d at %d,%d,%d"),
+			Piece.Size, static_cast<int32>(Piece.MaterialId), X, Y, Z);
 		return;
 	}
 
-	auto& Column = Columns[ColIndex];
-	
-	const int32 NewStart = Z;
-	const int32 NewEnd   = NewStart + Piece.Size;
-
-	int32 CurZ = 0;
-	int32 Idx  = 0;
+	const FChunkColumnView Column = Columns->GetColumn(ColIndex);
+	const int32 NumPieces = Column.Num();
 
-	// Advance to the first piece that might overlap with the new piece
-	while (Idx < Column.Pieces.Num() && CurZ + Column.Pieces[Idx].Size <= NewStart)
+	// Above the column it lands on its top, and never goes past the height of the world
+	const int32 NewStart = FMath::Min(Z, Column.GetHeight());
+	const int32 NewEnd   = FMath::Min(NewStart + Piece.Size, GameConstants::Chunk::Height);
+	const int32 NewSize  = NewEnd - NewStart;
+	if (NewSize <= 0)
 	{
-		CurZ += Column.Pieces[Idx].Size;
-		++Idx;
+		return;
 	}
 
-	const int32 StartReplaceIdx = Idx;
-	TArray<FPiece> Insert;
+	// The column is rebuilt here and written back once, so the storage can decide where it goes
+	TArray<FPiece, TInlineAllocator<64>> NewPieces;
+	NewPieces.Reserve(NumPieces + 2);
 
-	if (Idx < Column.Pieces.Num())
+	// Appends merging neighbors with the same id, the source column is already merged
+	auto Push = [&NewPieces](const EMaterial MaterialId, const int32 Size)
 	{
+		if (NewPieces.Num() > 0 && NewPieces.Last().MaterialId == MaterialId)
+		{
+			NewPieces.Last().Size += Size;
+			return;
+		}
+
+		NewPieces.Emplace(MaterialId, static_cast<uint16>(Size));
+	};
+
+	// Keep every piece that ends before the new piece starts
+	int32 Idx = Column.FindPieceIndex(NewStart);
+	if (Idx == INDEX_NONE)
+	{
+		Idx = NewStart < 0 ? 0 : NumPieces;
+	}
+	int32 CurZ = Idx < NumPieces ? Column.GetStart(Idx) : Column.GetHeight();
+	for (int32 i = 0; i < Idx; ++i)
+	{
+		NewPieces.Add(Column[i]);
+	}
+
+	if (Idx < NumPieces)
+	{
+		const FPiece FirstOverlapped = Column[Idx];
 		const int32 AmountBeforeStart = FMath::Max<int32>(0, NewStart - CurZ);
 		if (AmountBeforeStart > 0)
 		{
 			// keep the bottom of the first overlapped piece
-			Insert.Emplace(Column.Pieces[Idx].MaterialId, AmountBeforeStart);
+			Push(FirstOverlapped.MaterialId, AmountBeforeStart);
 			
-			OutChangedPieces.Key.Emplace(Column.Pieces[Idx].MaterialId, CurZ, Column.Pieces[Idx].Size - AmountBeforeStart, 0);
+			OutChangedPieces.Key.Emplace(FirstOverlapped.MaterialId, CurZ, FirstOverlapped.Size - AmountBeforeStart, 0);
 		}
 	}
 
 	// Advance until the end of the new piece
-	while (Idx < Column.Pieces.Num() &&
-		   CurZ + Column.Pieces[Idx].Size < NewEnd)
+	while (Idx < NumPieces && CurZ + Column[Idx].Size < NewEnd)
 	{
 		OutRemovedPiecesZ.Add(CurZ);
-		CurZ += Column.Pieces[Idx].Size;
+		CurZ += Column[Idx].Size;
 		++Idx;
 	}
 
-	Insert.Emplace(Piece.MaterialId, Piece.Size);
+	Push(Piece.MaterialId, NewSize);
 
-	const int32 StopReplaceIdx = Idx;
-	if (Idx < Column.Pieces.Num())
+	if (Idx < NumPieces)
 	{
-		const int32 PieceEndZ = CurZ + Column.Pieces[Idx].Size;
+		const FPiece LastOverlapped = Column[Idx];
+		const int32 PieceEndZ = CurZ + LastOverlapped.Size;
 		const int32 AmountAfterEnd = FMath::Max<int32>(0, PieceEndZ - static_cast<int32>(NewEnd));
 		if (AmountAfterEnd > 0)
 		{
-			OutChangedPieces.Value.Emplace(Column.Pieces[Idx].MaterialId, CurZ, Column.Pieces[Idx].Size - AmountAfterEnd, AmountAfterEnd);
-			Insert.Emplace(Column.Pieces[Idx].MaterialId, AmountAfterEnd);
+			OutChangedPieces.Value.Emplace(LastOverlapped.MaterialId, CurZ, LastOverlapped.Size - AmountAfterEnd, AmountAfterEnd);
+			Push(LastOverlapped.MaterialId, AmountAfterEnd);
 		} else if (CurZ < NewEnd) {
 			// Fully covered terminal piece whose end == NewEnd
 			OutRemovedPiecesZ.Add(CurZ);
 		}
-	}
 
-	// Remove overlapped range [StartReplaceIdx - StopReplaceIdx] if any
-	if (StartReplaceIdx < Column.Pieces.Num())
-	{
-		// If we ended past the end, remove through the last element
-		const int32 InclusiveStop = StopReplaceIdx >= StartReplaceIdx && StopReplaceIdx < Column.Pieces.Num()
-									? StopReplaceIdx
-									: Column.Pieces.Num() - 1;
-		const int32 NumToRemove = InclusiveStop >= StartReplaceIdx ? InclusiveStop - StartReplaceIdx + 1 : 0;
-		if (NumToRemove > 0)
+		// Keep everything above the new piece
+		for (++Idx; Idx < NumPieces; ++Idx)
 		{
-			Column.Pieces.RemoveAt(StartReplaceIdx, NumToRemove);
+			Push(Column[Idx].MaterialId, Column[Idx].Size);
 		}
-		// Insert at StartReplaceIdx
-		Column.Pieces.Insert(Insert, StartReplaceIdx);
 	}
-	else
+
+	GetMutableColumns().SetColumn(ColIndex, NewPieces);
+	DirtyColumns[ColIndex] = true;
+
+	Changes++;
+}
+
+void FChunkData::Th_SetPiece(const int32 X, const int32 Y, const int32 Z, const FPiece& Piece)
+{
+	TArray<uint16> Tmp;
+	TPair<TOptional<FChangeFromSet>, TOptional<FChangeFromSet>> Tmp2;
+	Th_SetPiece(X, Y, Z, Piece, Tmp, Tmp2);
+}
+
+void FChunkData::Th_ApplyEdits(const FChunkEdits& Edits)
+{
+	if (Edits.Columns.IsEmpty())
 	{
-		// Insert at the very end, nothing removed
-		Column.Pieces.Append(Insert);
+		return;
 	}
 
-	// Merge neighbors with the same id
-	for (int32 i = 1; i < Column.Pieces.Num(); )
+	FColumnsWriteScope WriteScope(*this);
+	FChunkColumnStorage& MutableColumns = GetMutableColumns();
+
+	// Columns are expanded to one material per layer, every edit becomes a fill and the result is merged back once
+	TArray<EMaterial> Layers;
+	TArray<FPiece, TInlineAllocator<64>> NewPieces;
+
+	auto Expand = [&Layers](const auto& Pieces)
 	{
-		if (Column.Pieces[i - 1].MaterialId == Column.Pieces[i].MaterialId)
+		for (const FPiece Piece : Pieces)
 		{
-			Column.Pieces[i - 1].Size += Column.Pieces[i].Size;
-			Column.Pieces.RemoveAt(i);
+			const int32 Start = Layers.AddUninitialized(Piece.Size);
+			FMemory::Memset(Layers.GetData() + Start, static_cast<uint8>(Piece.MaterialId), Piece.Size);
+		}
+	};
+
+	for (const auto& [ColIndex, ColumnEdits] : Edits.Columns)
+	{
+		if (!MutableColumns.IsValidColumnIndex(ColIndex))
+		{
+			UE_LOG(LogChunk, Warning, TEXT("ApplyEdits: Invalid column index %d"), ColIndex);
 			continue;
 		}
 
-		++i;
+		Layers.Reset();
+		if (ColumnEdits.Replacement.IsSet())
+		{
+			Expand(ColumnEdits.Replacement.GetValue());
+		}
+		else
+		{
+			Expand(MutableColumns.GetColumn(ColIndex));
+		}
+
+		for (const FPieceEdit& Edit : ColumnEdits.Pieces)
+		{
+			if (Edit.Z < 0 || Edit.Piece.Size <= 0 || !MaterialUtils::IsValid(Edit.Piece.MaterialId))
+			{
+				continue;
+			}
+
+			// Same as Th_SetPiece, a piece above the column lands on its top without void in between
+			const int32 Start = FMath::Min(Edit.Z, Layers.Num());
+			const int32 End = FMath::Min(Start + Edit.Piece.Size, GameConstants::Chunk::Height);
+			if (Start >= End)
+			{
+				continue;
+			}
+
+			if (End > Layers.Num())
+			{
+				Layers.AddUninitialized(End - Layers.Num());
+			}
+			FMemory::Memset(Layers.GetData() + Start, static_cast<uint8>(Edit.Piece.MaterialId), End - Start);
+		}
+
+		NewPieces.Reset();
+		for (const EMaterial MaterialId : Layers)
+		{
+			if (NewPieces.Num() > 0 && NewPieces.Last().MaterialId == MaterialId && NewPieces.Last().Size < FPackedPiece::MaxSize)
+			{
+				NewPieces.Last().Size++;
+				continue;
+			}
+
+			NewPieces.Emplace(MaterialId, 1);
+		}
+
+		MutableColumns.SetColumn(ColIndex, NewPieces);
+		DirtyColumns[ColIndex] = true;
 	}
 
 	Changes++;
 }
 
-void UChunkData::Th_SetPiece(const int32 X, const int32 Y, const int32 Z, const FPiece& Piece)
-{
-	TArray<uint16> Tmp;
-	TPair<TOptional<FChangeFromSet>, TOptional<FChangeFromSet>> Tmp2;
-	Th_SetPiece(X, Y, Z, Piece, Tmp, Tmp2);
-}
-
-bool UChunkData::HasWorldItemAt(const FVector& LocalPosition) const
+bool FChunkData::HasWorldItemAt(const FVector& LocalPosition) const
 {
 	const FIntVector GridPos = GetGridPosition(LocalPosition);
 	const TWeakObjectPtr<AItemWorldActor>* ItemPtr = WorldItemGrid.Find(GridPos);
 	return ItemPtr && ItemPtr->IsValid();
 }
 
-void UChunkData::RegisterWorldItem(const FVector& LocalPosition, AItemWorldActor* WorldItem)
+void FChunkData::RegisterWorldItem(const FVector& LocalPosition, AItemWorldActor* WorldItem)
 {
 	if (WorldItem)
 	{
@@ -326,13 +573,13 @@ void UChunkData::RegisterWorldItem(const FVector& LocalPosition, AItemWorldActor
 	}
 }
 
-void UChunkData::UnregisterWorldItem(const FVector& LocalPosition)
+void FChunkData::UnregisterWorldItem(const FVector& LocalPosition)
 {
 	const FIntVector GridPos = GetGridPosition(LocalPosition);
 	WorldItemGrid.Remove(GridPos);
 }
 
-TArray<AItemWorldActor*> UChunkData::GetWorldItems() const
+TArray<AItemWorldActor*> FChunkData::GetWorldItems() const
 {
 	TArray<AItemWorldActor*> Result;
 	for (const auto& Pair : WorldItemGrid)
@@ -3,7 +3,9 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "ChunkColumn.h"
+#include <atomic>
+#include "ChunkColumnStorage.h"
+#include "ChunkSnapshot.h"
 #include "PieceWithStart.h"
 #include "Bluevox/Chunk/Position/ChunkPosition.h"
 #include "Bluevox/Chunk/Position/LocalColumnPosition.h"
@@ -15,6 +17,7 @@
 #include "ChunkData.generated.h"
 
 struct FGlobalPosition;
+struct FChunkEdits;
 class AGameManager;
 class AItemWorldActor;
 class UItemTypeDataAsset;
@@ -90,49 +93,61 @@ struct FWorldItemData
 };
 
 /**
- *
+ * Voxel data of a loaded chunk. Plain C++ on purpose: chunks live in FChunkDataStore slabs owned by UChunkRegistry,
+ * so the garbage collector never has to walk them, however many are resident.
  */
-UCLASS()
-class BLUEVOX_API UChunkData : public UObject
+class BLUEVOX_API FChunkData
 {
-	GENERATED_BODY()
-	
 public:
-	UChunkData* Init(AGameManager* InGameManager, const FChunkPosition InPosition, TArray<FChunkColumn>&& InColumns,
+	FChunkData* Init(AGameManager* InGameManager, const FChunkPosition InPosition,
+	                 const TSharedRef<const FChunkColumnStorage, ESPMode::ThreadSafe>& InColumns,
 	                 TArray<FEntityRecord>&& InEntities = TArray<FEntityRecord>());
 
-	UPROPERTY()
-	TArray<FChunkColumn> Columns;
-
 	// Persistent entity records stored in this chunk (server authoritative)
 	TSparseArray<FEntityRecord> Entities;
 
+	// Entities flattened for saving and sending
+	TArray<FEntityRecord> GetEntityRecords() const;
+
+	// Memory held by the columns only this chunk references, shared columns are left out
+	SIZE_T Th_GetColumnsAllocatedSize();
+
+	SIZE_T GetEntitiesAllocatedSize() const
+	{
+		return Entities.GetAllocatedSize() + WorldItemGrid.GetAllocatedSize();
+	}
+
 	// World item tracking - maps grid position to item actor
-	UPROPERTY()
 	TMap<FIntVector, TWeakObjectPtr<AItemWorldActor>> WorldItemGrid;
 
-	UPROPERTY()
-	AGameManager* GameManager;
+	AGameManager* GameManager = nullptr;
 
-	UPROPERTY()
 	FChunkPosition Position;
 
-	UPROPERTY()
 	int32 Changes = 0;
 
+	// Changes when the chunk last matched its region file, INDEX_NONE if it was never written there
+	int32 SavedChanges = INDEX_NONE;
+
+	bool IsDirty() const
+	{
+		return Changes != SavedChanges;
+	}
+
 	FRWLock Lock;
 	
-	virtual void Serialize(FArchive& Ar) override;
-
 	void SerializeForSave(FArchive& Ar);
 
 	int32 GetFirstGapThatFits(const FGlobalPosition& GlobalPosition, const int32 FitHeightInLayers);
 	
 	int32 GetFirstGapThatFits(const int32 X, const int32 Y, const int32 FitHeightInLayers);
 
-	bool DoesFit(const FGlobalPosition& GlobalPosition, const int32 FitHeightInLayers) const;
+	bool DoesFit(const FGlobalPosition& GlobalPosition, const int32 FitHeightInLayers);
 	
-	bool DoesFit(const int32 X, const int32 Y, const int32 Z, const int32 FitHeightInLayers) const;
+	bool DoesFit(const int32 X, const int32 Y, const int32 Z, const int32 FitHeightInLayers);
+
+	// Batched DoesFit for many heights of the same column, OutFits[i] is the result for Zs[i]
+	void DoesFit(const int32 X, const int32 Y, TConstArrayView<int32> Zs, const int32 FitHeightInLayers, TBitArray<>& OutFits);
 
 	static int32 GetIndex(const int32 X, const int32 Y)
 	{
@@ -144,19 +159,29 @@ public:
 		return ColumnPosition.X + ColumnPosition.Y * GameConstants::Chunk::Size;
 	}
 	
-	FChunkColumn& GetColumn(const FLocalColumnPosition ColumnPosition)
-	{
-		return Columns[GetIndex(ColumnPosition)];
-	}
+	// Current columns, versioned by Changes. Only holds the lock long enough to copy a reference
+	FChunkSnapshot Th_GetSnapshot();
 
 	inline FPieceWithStart Th_GetPieceCopy(FLocalPosition LocalPosition);
 	
 	FPieceWithStart Th_GetPieceCopy(const int32 X, const int32 Y, const int32 Z);
 
+	// Batched Th_GetPieceCopy, reads the column once. OutPieces[i] is the piece at Zs[i], default when out of the column
+	void Th_GetPieceCopies(const int32 X, const int32 Y, TConstArrayView<int32> Zs, TArray<FPieceWithStart>& OutPieces);
+
 	void Th_SetPiece(const int32 X, const int32 Y, const int32 Z, const FPiece& Piece, TArray<uint16>& OutRemovedPiecesZ, TPair<TOptional<FChangeFromSet>, TOptional<FChangeFromSet>>& OutChangedPieces);
 
 	void Th_SetPiece(const int32 X, const int32 Y, const int32 Z, const FPiece& Piece);
 
+	// Applies a batch in one go: one lock, one rewrite per column and a single Changes bump
+	void Th_ApplyEdits(const FChunkEdits& Edits);
+
+	// Flags a column whose mesh is stale without it changing, e.g. when the column next to it in another chunk changed
+	void Th_MarkColumnDirty(const int32 ColIndex);
+
+	// Columns changed since the last call, one bit per column index. Clears them
+	void Th_TakeDirtyColumns(TBitArray<>& OutDirtyColumns);
+
 	// Check if world item exists at grid position
 	bool HasWorldItemAt(const FVector& LocalPosition) const;
 
@@ -174,4 +199,44 @@ public:
 	{
 		return FIntVector(LocalPosition / 100.0f);
 	}
+
+private:
+	// Shared with the snapshots handed out, never written while someone else references it
+	TSharedPtr<const FChunkColumnStorage, ESPMode::ThreadSafe> Columns = MakeShared<FChunkColumnStorage, ESPMode::ThreadSafe>();
+
+	// Columns for writing, copies them first if a snapshot still points to the current ones. Needs a FColumnsWriteScope
+	FChunkColumnStorage& GetMutableColumns();
+
+	// Write lock for anything touching Columns, also flags the write to unlocked readers and waits for them to leave
+	struct FColumnsWriteScope
+	{
+		explicit FColumnsWriteScope(FChunkData& InChunkData);
+
+		~FColumnsWriteScope();
+
+	private:
+		FChunkData& ChunkData;
+
+		FWriteScopeLock WriteLock;
+	};
+
+	/**
+	 * Runs Read once on the columns. Not a seqlock: the read is never validated afterwards, a reader counts itself in
+	 * UnlockedReaders instead and column writes wait for it to leave, so it can't overlap one. That skips the RW lock
+	 * the write holders that leave the columns alone take, but still writes the shared counter twice per read.
+	 * Takes the read lock when a column write is going on or starts while it gets in.
+	 */
+	template <typename FuncType>
+	void Th_ReadColumns(FuncType&& Read);
+
+	// Odd while the columns are being written, unlocked reads check it before and after counting themselves in
+	std::atomic<uint32> ColumnsSequence = 0;
+
+	// Unlocked reads in flight, column writes wait for them to leave so no read ever walks freed memory
+	std::atomic<int32> UnlockedReaders = 0;
+
+	// Columns written since the chunk mesh last picked them up, guarded by Lock
+	TBitArray<> DirtyColumns;
+
+	static bool DoesFitInColumn(const FChunkColumnView& Column, const int32 Z, const int32 FitHeightInLayers);
 };
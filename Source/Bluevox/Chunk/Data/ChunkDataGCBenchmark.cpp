@@ -0,0 +1,78 @@
+﻿#include "ChunkDataGCBenchmark.h"
+
+#include "ChunkDataStore.h"
+#include "Bluevox/Chunk/LogChunk.h"
+#include "Bluevox/Game/GameConstants.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace
+{
+	constexpr int32 GCPasses = 5;
+
+	// Pieces per column of the probes, about what generated terrain has
+	constexpr int32 PiecesPerColumn = 4;
+
+	double MeasureGCMilliseconds()
+	{
+		double TotalSeconds = 0.0;
+		for (int32 Pass = 0; Pass < GCPasses; ++Pass)
+		{
+			const double Start = FPlatformTime::Seconds();
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+			TotalSeconds += FPlatformTime::Seconds() - Start;
+		}
+		return TotalSeconds * 1000.0 / GCPasses;
+	}
+}
+
+static FAutoConsoleCommand CmdChunkDataGCBenchmark(
+	TEXT("game.chunk.store.gc_benchmark"),
+	TEXT("Compares full garbage collections with N chunks as UObjects against N chunks in a chunk data store (default 10000)"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const int32 Count = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 10000;
+
+		const double BaselineMs = MeasureGCMilliseconds();
+
+		double ObjectsMs;
+		{
+			TArray<UChunkDataGCProbe*> Probes;
+			Probes.Reserve(Count);
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				UChunkDataGCProbe* Probe = NewObject<UChunkDataGCProbe>();
+				Probe->Position = FChunkPosition{Index, 0};
+				Probe->Columns.SetNum(FMath::Square(GameConstants::Chunk::Size));
+				for (FChunkColumnGCProbe& Column : Probe->Columns)
+				{
+					Column.Pieces.Init(FPiece(EMaterial::Dirt, 1), PiecesPerColumn);
+				}
+				Probe->AddToRoot();
+				Probes.Add(Probe);
+			}
+
+			ObjectsMs = MeasureGCMilliseconds();
+
+			for (UChunkDataGCProbe* Probe : Probes)
+			{
+				Probe->RemoveFromRoot();
+			}
+		}
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+
+		double StoreMs;
+		{
+			FChunkDataStore Store;
+			const TSharedRef<const FChunkColumnStorage, ESPMode::ThreadSafe> Columns =
+				MakeShared<FChunkColumnStorage, ESPMode::ThreadSafe>();
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				Store.Get(Store.Allocate())->Init(nullptr, FChunkPosition{Index, 0}, Columns);
+			}
+
+			StoreMs = MeasureGCMilliseconds();
+		}
+
+		UE_LOG(LogChunk, Display, TEXT("GC with %d chunks: %.3f ms as UObjects, %.3f ms in the store, %.3f ms baseline"),
+			Count, ObjectsMs, StoreMs, BaselineMs);
+	}));
@@ -0,0 +1,46 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Piece.h"
+#include "Bluevox/Chunk/Position/ChunkPosition.h"
+#include "UObject/Object.h"
+#include "ChunkDataGCBenchmark.generated.h"
+
+class AGameManager;
+class AItemWorldActor;
+
+// Stand in for the reflected column the chunk data used to hold, one per column of the chunk
+USTRUCT()
+struct FChunkColumnGCProbe
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FPiece> Pieces;
+};
+
+/**
+ * Stand in for the chunk data as it used to be, a reflected UObject per chunk with its reflected columns.
+ * Only used by game.chunk.store.gc_benchmark, to compare the collector cost of both layouts.
+ */
+UCLASS()
+class BLUEVOX_API UChunkDataGCProbe : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	TArray<FChunkColumnGCProbe> Columns;
+
+	UPROPERTY()
+	TMap<FIntVector, TWeakObjectPtr<AItemWorldActor>> WorldItemGrid;
+
+	UPROPERTY()
+	AGameManager* GameManager = nullptr;
+
+	UPROPERTY()
+	FChunkPosition Position;
+
+	UPROPERTY()
+	int32 Changes = 0;
+};
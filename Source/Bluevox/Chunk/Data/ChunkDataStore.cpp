@@ -0,0 +1,90 @@
+﻿#include "ChunkDataStore.h"
+
+FChunkDataStore::~FChunkDataStore()
+{
+	for (const TUniquePtr<FSlab>& Slab : Slabs)
+	{
+		for (FSlot& Slot : Slab->Slots)
+		{
+			if (Slot.bLive)
+			{
+				Slot.Data.GetTypedPtr()->~FChunkData();
+			}
+		}
+	}
+}
+
+FChunkDataHandle FChunkDataStore::Allocate()
+{
+	FWriteScopeLock WriteLock(Lock);
+
+	if (FreeIndices.IsEmpty())
+	{
+		// Pushed in reverse so slots are handed out in address order
+		const uint32 FirstIndex = Slabs.Num() * SlabSize;
+		Slabs.Add(MakeUnique<FSlab>());
+		for (int32 Offset = SlabSize - 1; Offset >= 0; --Offset)
+		{
+			FreeIndices.Add(FirstIndex + Offset);
+		}
+	}
+
+	const uint32 Index = FreeIndices.Pop(EAllowShrinking::No);
+	FSlot& Slot = Slabs[Index / SlabSize]->Slots[Index % SlabSize];
+	new (Slot.Data.GetTypedPtr()) FChunkData();
+	Slot.bLive = true;
+	NumLive++;
+
+	return FChunkDataHandle{Index, Slot.Generation};
+}
+
+void FChunkDataStore::Free(const FChunkDataHandle Handle)
+{
+	FWriteScopeLock WriteLock(Lock);
+
+	FSlot* Slot = FindSlot(Handle);
+	if (!Slot)
+	{
+		return;
+	}
+
+	Slot->Data.GetTypedPtr()->~FChunkData();
+	Slot->bLive = false;
+
+	// Skips 0 when wrapping around, it marks invalid handles
+	Slot->Generation = FMath::Max(Slot->Generation + 1, 1u);
+
+	FreeIndices.Add(Handle.Index);
+	NumLive--;
+}
+
+FChunkData* FChunkDataStore::Get(const FChunkDataHandle Handle) const
+{
+	FReadScopeLock ReadLock(Lock);
+
+	FSlot* Slot = FindSlot(Handle);
+	return Slot ? Slot->Data.GetTypedPtr() : nullptr;
+}
+
+int32 FChunkDataStore::Num() const
+{
+	FReadScopeLock ReadLock(Lock);
+	return NumLive;
+}
+
+SIZE_T FChunkDataStore::GetAllocatedSize() const
+{
+	FReadScopeLock ReadLock(Lock);
+	return Slabs.Num() * sizeof(FSlab) + Slabs.GetAllocatedSize() + FreeIndices.GetAllocatedSize();
+}
+
+FChunkDataStore::FSlot* FChunkDataStore::FindSlot(const FChunkDataHandle Handle) const
+{
+	if (!Handle.IsValid() || Handle.Index >= static_cast<uint32>(Slabs.Num() * SlabSize))
+	{
+		return nullptr;
+	}
+
+	FSlot& Slot = Slabs[Handle.Index / SlabSize]->Slots[Handle.Index % SlabSize];
+	return Slot.bLive && Slot.Generation == Handle.Generation ? &Slot : nullptr;
+}
@@ -0,0 +1,91 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "ChunkData.h"
+
+/**
+ * Reference to a chunk in FChunkDataStore. Slots are reused, the generation tells a stale handle from the chunk
+ * that took its slot afterwards.
+ */
+struct FChunkDataHandle
+{
+	uint32 Index = 0;
+
+	// 0 is never handed out, a default handle is invalid
+	uint32 Generation = 0;
+
+	bool IsValid() const
+	{
+		return Generation != 0;
+	}
+
+	bool operator==(const FChunkDataHandle& Other) const
+	{
+		return Index == Other.Index && Generation == Other.Generation;
+	}
+
+	friend uint32 GetTypeHash(const FChunkDataHandle& Handle)
+	{
+		return HashCombineFast(Handle.Index, Handle.Generation);
+	}
+};
+
+/**
+ * Pool of FChunkData, outside of the UObject graph.
+ * Chunks are constructed in place in fixed size slabs that are never moved nor released, so a chunk keeps its
+ * address until freed, and loading and unloading chunks reuses the same memory instead of going to the allocator.
+ * Thread safe.
+ */
+class BLUEVOX_API FChunkDataStore
+{
+public:
+	static constexpr int32 SlabSize = 256;
+
+	FChunkDataStore()
+	{
+	}
+
+	FChunkDataStore(const FChunkDataStore&) = delete;
+
+	FChunkDataStore& operator=(const FChunkDataStore&) = delete;
+
+	~FChunkDataStore();
+
+	/** Default constructs a chunk in a free slot, initialize it through FChunkData::Init. */
+	FChunkDataHandle Allocate();
+
+	/** Destroys the chunk, the handle and every copy of it become stale. */
+	void Free(const FChunkDataHandle Handle);
+
+	/** nullptr when the handle is invalid or stale. */
+	FChunkData* Get(const FChunkDataHandle Handle) const;
+
+	int32 Num() const;
+
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	struct FSlot
+	{
+		TTypeCompatibleBytes<FChunkData> Data;
+
+		uint32 Generation = 1;
+
+		bool bLive = false;
+	};
+
+	struct FSlab
+	{
+		FSlot Slots[SlabSize];
+	};
+
+	FSlot* FindSlot(const FChunkDataHandle Handle) const;
+
+	mutable FRWLock Lock;
+
+	TArray<TUniquePtr<FSlab>> Slabs;
+
+	TArray<uint32> FreeIndices;
+
+	int32 NumLive = 0;
+};
@@ -0,0 +1,98 @@
+﻿#include "ChunkEditBatch.h"
+
+#include "ChunkData.h"
+#include "Bluevox/Chunk/Position/GlobalPosition.h"
+#include "Bluevox/Chunk/Position/LocalColumnPosition.h"
+#include "Bluevox/Game/GameConstants.h"
+
+void FChunkEditBatch::SetPiece(const FGlobalPosition& Position, const FPiece& Piece)
+{
+	if (Piece.Size <= 0)
+	{
+		return;
+	}
+
+	FindOrAddColumn(FColumnPosition(Position.X, Position.Y)).Pieces.Add(FPieceEdit{Position.Z, Piece});
+}
+
+void FChunkEditBatch::SetPieces(const TConstArrayView<FGlobalPosition> Positions, const FPiece& Piece)
+{
+	for (const FGlobalPosition& Position : Positions)
+	{
+		SetPiece(Position, Piece);
+	}
+}
+
+void FChunkEditBatch::FillBox(const FGlobalPosition& Min, const FGlobalPosition& Max, const EMaterial MaterialId)
+{
+	const int32 MinX = FMath::Min(Min.X, Max.X);
+	const int32 MaxX = FMath::Max(Min.X, Max.X);
+	const int32 MinY = FMath::Min(Min.Y, Max.Y);
+	const int32 MaxY = FMath::Max(Min.Y, Max.Y);
+	const int32 MinZ = FMath::Min(Min.Z, Max.Z);
+	const int32 MaxZ = FMath::Max(Min.Z, Max.Z);
+
+	for (int32 X = MinX; X <= MaxX; ++X)
+	{
+		for (int32 Y = MinY; Y <= MaxY; ++Y)
+		{
+			AddSpan(FColumnPosition(X, Y), MinZ, MaxZ, MaterialId);
+		}
+	}
+}
+
+void FChunkEditBatch::FillSphere(const FGlobalPosition& Center, const float RadiusInBlocks, const EMaterial MaterialId)
+{
+	if (RadiusInBlocks <= 0.0f)
+	{
+		return;
+	}
+
+	const float LayersPerBlock = GameConstants::Scaling::XYWorldSize / GameConstants::Scaling::ZWorldSize;
+	const float RadiusSquared = FMath::Square(RadiusInBlocks);
+	const int32 Extent = FMath::FloorToInt(RadiusInBlocks);
+
+	for (int32 DX = -Extent; DX <= Extent; ++DX)
+	{
+		for (int32 DY = -Extent; DY <= Extent; ++DY)
+		{
+			const float DistanceSquared = FMath::Square(static_cast<float>(DX)) + FMath::Square(static_cast<float>(DY));
+			if (DistanceSquared > RadiusSquared)
+			{
+				continue;
+			}
+
+			const int32 HalfHeight = FMath::RoundToInt(FMath::Sqrt(RadiusSquared - DistanceSquared) * LayersPerBlock);
+			AddSpan(FColumnPosition(Center.X + DX, Center.Y + DY), Center.Z - HalfHeight, Center.Z + HalfHeight, MaterialId);
+		}
+	}
+}
+
+void FChunkEditBatch::ReplaceColumn(const FColumnPosition& Position, TArray<FPiece>&& Pieces)
+{
+	FColumnEdits& Column = FindOrAddColumn(Position);
+	Column.Pieces.Reset();
+	Column.Replacement = MoveTemp(Pieces);
+}
+
+FColumnEdits& FChunkEditBatch::FindOrAddColumn(const FColumnPosition& Position)
+{
+	const FChunkPosition ChunkPosition = FChunkPosition::FromColumnPosition(Position);
+	const FLocalColumnPosition LocalPosition = FLocalColumnPosition::FromColumnPosition(Position);
+
+	return Chunks.FindOrAdd(ChunkPosition).Columns.FindOrAdd(FChunkData::GetIndex(LocalPosition.X, LocalPosition.Y));
+}
+
+void FChunkEditBatch::AddSpan(const FColumnPosition& Position, int32 MinZ, int32 MaxZ, const EMaterial MaterialId)
+{
+	// Shapes are clipped to the world, a single piece never outgrows the packed size that way
+	MinZ = FMath::Max(MinZ, 0);
+	MaxZ = FMath::Min(MaxZ, GameConstants::Chunk::Height - 1);
+	const int32 Size = MaxZ - MinZ + 1;
+	if (Size <= 0)
+	{
+		return;
+	}
+
+	FindOrAddColumn(Position).Pieces.Add(FPieceEdit{MinZ, FPiece(MaterialId, static_cast<uint16>(Size))});
+}
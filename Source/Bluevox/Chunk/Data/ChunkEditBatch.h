@@ -0,0 +1,73 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Piece.h"
+#include "Bluevox/Chunk/Position/ChunkPosition.h"
+#include "Bluevox/Chunk/Position/ColumnPosition.h"
+
+struct FGlobalPosition;
+
+/** A piece written at Z, same meaning as FChunkData::Th_SetPiece. */
+struct FPieceEdit
+{
+	int32 Z = 0;
+
+	FPiece Piece;
+};
+
+/** Everything written to a single column by a batch, applied in order on top of Replacement or the current column. */
+struct FColumnEdits
+{
+	TOptional<TArray<FPiece>> Replacement;
+
+	TArray<FPieceEdit, TInlineAllocator<4>> Pieces;
+};
+
+/** Edits of a single chunk, by column index. */
+struct FChunkEdits
+{
+	TMap<int32, FColumnEdits> Columns;
+};
+
+/**
+ * Voxel edits grouped by chunk and column, applied at once through UChunkRegistry::SetPieces.
+ * However many edits land on a column it's rewritten once, and every touched chunk is rendered once.
+ * Shapes are cut into vertical spans, a box or a sphere costs one edit per column instead of one per block.
+ */
+struct BLUEVOX_API FChunkEditBatch
+{
+	void SetPiece(const FGlobalPosition& Position, const FPiece& Piece);
+
+	void SetPieces(TConstArrayView<FGlobalPosition> Positions, const FPiece& Piece);
+
+	/** Fills every block between Min and Max, both included. */
+	void FillBox(const FGlobalPosition& Min, const FGlobalPosition& Max, const EMaterial MaterialId);
+
+	/** Fills a sphere of RadiusInBlocks around Center, in world proportions, layers are thinner than blocks. */
+	void FillSphere(const FGlobalPosition& Center, const float RadiusInBlocks, const EMaterial MaterialId);
+
+	/** Replaces the whole column, edits queued before on it are dropped. */
+	void ReplaceColumn(const FColumnPosition& Position, TArray<FPiece>&& Pieces);
+
+	const TMap<FChunkPosition, FChunkEdits>& GetChunks() const
+	{
+		return Chunks;
+	}
+
+	bool IsEmpty() const
+	{
+		return Chunks.IsEmpty();
+	}
+
+	void Reset()
+	{
+		Chunks.Reset();
+	}
+
+private:
+	FColumnEdits& FindOrAddColumn(const FColumnPosition& Position);
+
+	void AddSpan(const FColumnPosition& Position, int32 MinZ, int32 MaxZ, const EMaterial MaterialId);
+
+	TMap<FChunkPosition, FChunkEdits> Chunks;
+};
@@ -0,0 +1,39 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "ChunkColumnStorage.h"
+#include "Bluevox/Chunk/Position/ChunkPosition.h"
+
+/**
+ * Immutable columns of a chunk, as they were when FChunkData::Changes was Version.
+ * Grabbing one only copies a reference, the chunk copies its storage on the next write instead of touching it,
+ * so a snapshot can be read from any thread, for as long as needed, without holding the chunk lock.
+ */
+struct FChunkSnapshot
+{
+	FChunkSnapshot()
+	{
+	}
+
+	FChunkSnapshot(const FChunkPosition& InPosition, const TSharedPtr<const FChunkColumnStorage, ESPMode::ThreadSafe>& InColumns,
+		const int32 InVersion)
+		: Position(InPosition), Columns(InColumns), Version(InVersion)
+	{
+	}
+
+	bool IsValid() const
+	{
+		return Columns.IsValid();
+	}
+
+	FChunkColumnView GetColumn(const int32 ColumnIndex) const
+	{
+		return Columns->GetColumn(ColumnIndex);
+	}
+
+	FChunkPosition Position;
+
+	TSharedPtr<const FChunkColumnStorage, ESPMode::ThreadSafe> Columns;
+
+	int32 Version = INDEX_NONE;
+};
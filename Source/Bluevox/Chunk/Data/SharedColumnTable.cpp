@@ -0,0 +1,172 @@
+﻿#include "SharedColumnTable.h"
+
+#include "Bluevox/Chunk/ChunkStats.h"
+#include "Bluevox/Chunk/LogChunk.h"
+#include "Containers/StaticArray.h"
+
+FSharedColumn::FSharedColumn(const uint32 InHash, const FChunkColumnView& Column)
+	: Hash(InHash), NumPieces(Column.Num())
+{
+	Buffer.SetNumUninitialized(NumPieces * 2);
+	for (int32 PieceIndex = 0; PieceIndex < NumPieces; ++PieceIndex)
+	{
+		const FPiece Piece = Column[PieceIndex];
+		Buffer[PieceIndex] = FPackedPiece(Piece.Size, static_cast<int32>(Piece.MaterialId)).Bits;
+		Buffer[NumPieces + PieceIndex] = static_cast<uint16>(Column.GetStart(PieceIndex));
+	}
+}
+
+bool FSharedColumn::Equals(const FChunkColumnView& Column) const
+{
+	if (Column.Num() != NumPieces)
+	{
+		return false;
+	}
+
+	const FChunkColumnView Self = GetView();
+	for (int32 PieceIndex = 0; PieceIndex < NumPieces; ++PieceIndex)
+	{
+		const FPiece A = Self[PieceIndex];
+		const FPiece B = Column[PieceIndex];
+		if (A.MaterialId != B.MaterialId || A.Size != B.Size)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+uint32 FSharedColumn::HashColumn(const FChunkColumnView& Column)
+{
+	// Hashes decoded pieces, the same column packed against two chunk palettes must collide
+	uint32 Hash = GetTypeHash(Column.Num());
+	for (const FPiece Piece : Column)
+	{
+		Hash = HashCombineFast(Hash, static_cast<uint32>(Piece.MaterialId) << 16 | Piece.Size);
+	}
+
+	return Hash;
+}
+
+const EMaterial* FSharedColumn::GetIdentityPalette()
+{
+	static const TStaticArray<EMaterial, FPackedPiece::MaxPaletteSize> IdentityPalette = []
+	{
+		TStaticArray<EMaterial, FPackedPiece::MaxPaletteSize> Palette;
+		for (int32 Index = 0; Index < FPackedPiece::MaxPaletteSize; ++Index)
+		{
+			Palette[Index] = static_cast<EMaterial>(Index);
+		}
+		return Palette;
+	}();
+
+	return IdentityPalette.GetData();
+}
+
+FSharedColumnTable& FSharedColumnTable::Get()
+{
+	static FSharedColumnTable Table;
+	return Table;
+}
+
+FSharedColumnRef FSharedColumnTable::Intern(const FChunkColumnView& Column)
+{
+	const uint32 Hash = FSharedColumn::HashColumn(Column);
+
+	auto FindExisting = [this, Hash, &Column]() -> TSharedPtr<const FSharedColumn, ESPMode::ThreadSafe>
+	{
+		for (auto It = Columns.CreateConstKeyIterator(Hash); It; ++It)
+		{
+			TSharedPtr<const FSharedColumn, ESPMode::ThreadSafe> Existing = It.Value().Pin();
+			if (Existing.IsValid() && Existing->Equals(Column))
+			{
+				return Existing;
+			}
+		}
+
+		return nullptr;
+	};
+
+	{
+		FReadScopeLock ReadLock(Lock);
+		if (auto Existing = FindExisting())
+		{
+			return Existing.ToSharedRef();
+		}
+	}
+
+	FWriteScopeLock WriteLock(Lock);
+
+	// Another thread may have added it between the two locks
+	if (auto Existing = FindExisting())
+	{
+		return Existing.ToSharedRef();
+	}
+
+	if (++InsertsSincePrune >= InsertsBetweenPrunes)
+	{
+		PruneExpired();
+	}
+
+	FSharedColumnRef NewColumn = MakeShared<FSharedColumn, ESPMode::ThreadSafe>(Hash, Column);
+	Columns.Add(Hash, NewColumn);
+	return NewColumn;
+}
+
+FSharedColumnStats FSharedColumnTable::GetStats() const
+{
+	FReadScopeLock ReadLock(Lock);
+
+	FSharedColumnStats Stats;
+	Stats.OverheadBytes = Columns.GetAllocatedSize();
+	for (const auto& Pair : Columns)
+	{
+		const TSharedPtr<const FSharedColumn, ESPMode::ThreadSafe> Shared = Pair.Value.Pin();
+		if (!Shared.IsValid())
+		{
+			continue;
+		}
+
+		// Minus the pin above
+		const int32 References = Shared.GetSharedReferenceCount() - 1;
+		if (References <= 0)
+		{
+			continue;
+		}
+
+		Stats.UniqueColumns++;
+		Stats.References += References;
+		Stats.BytesSaved += static_cast<int64>(References - 1) * Shared->GetPayloadSize();
+		Stats.OverheadBytes += sizeof(FSharedColumn) + Shared->Buffer.GetAllocatedSize();
+	}
+
+	SET_DWORD_STAT(STAT_SharedColumns_Unique, Stats.UniqueColumns);
+	SET_MEMORY_STAT(STAT_SharedColumns_BytesSaved, Stats.BytesSaved);
+	SET_MEMORY_STAT(STAT_SharedColumns_Overhead, Stats.OverheadBytes);
+
+	return Stats;
+}
+
+void FSharedColumnTable::PruneExpired()
+{
+	InsertsSincePrune = 0;
+
+	for (auto It = Columns.CreateIterator(); It; ++It)
+	{
+		if (!It.Value().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+static FAutoConsoleCommand CmdSharedColumnStats(
+	TEXT("game.chunk.dedup.stats"),
+	TEXT("Logs how many columns are shared between chunks and how much memory it saves"),
+	FConsoleCommandDelegate::CreateLambda([]
+	{
+		const FSharedColumnStats Stats = FSharedColumnTable::Get().GetStats();
+		UE_LOG(LogChunk, Display, TEXT("Shared columns: %d unique, %lld references, %lld bytes saved, %lld bytes of overhead (net %lld)"),
+			Stats.UniqueColumns, Stats.References, Stats.BytesSaved, Stats.OverheadBytes, Stats.BytesSaved - Stats.OverheadBytes);
+	}));
@@ -0,0 +1,47 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "ChunkColumnStorage.h"
+
+struct FSharedColumnStats
+{
+	// Distinct columns currently referenced by at least one chunk
+	int32 UniqueColumns = 0;
+
+	// Chunk columns pointing to a shared column
+	int64 References = 0;
+
+	// Piece bytes chunks would hold on their own without deduplication, minus what the shared copies take
+	int64 BytesSaved = 0;
+
+	// Memory taken by the table itself and the shared column objects
+	int64 OverheadBytes = 0;
+};
+
+/**
+ * World-wide interning table of immutable columns, keyed by content hash.
+ * Flat worlds, oceans and untouched terrain produce the same columns over and over, chunks point to a single
+ * copy of those instead of holding their own. Entries are weak, a column goes away with the last chunk using it.
+ */
+class BLUEVOX_API FSharedColumnTable
+{
+public:
+	static FSharedColumnTable& Get();
+
+	/** Returns the shared copy of Column, adding it to the table if needed. Thread safe. */
+	FSharedColumnRef Intern(const FChunkColumnView& Column);
+
+	FSharedColumnStats GetStats() const;
+
+private:
+	// Expired entries are only dropped every so often, inserts would otherwise pay for it
+	static constexpr int32 InsertsBetweenPrunes = 4096;
+
+	void PruneExpired();
+
+	mutable FRWLock Lock;
+
+	TMultiMap<uint32, TWeakPtr<const FSharedColumn, ESPMode::ThreadSafe>> Columns;
+
+	int32 InsertsSincePrune = 0;
+};
@@ -8,10 +8,10 @@
 #include "Bluevox/Entity/EntityTypes.h"
 
 void UFlatWorldGenerator::GenerateChunk(const FChunkPosition& Position,
-                                        TArray<FChunkColumn>& OutColumns,
+                                        FChunkColumnStorage& OutColumns,
                                         TArray<FEntityRecord>& OutEntities)
 {
-	OutColumns.SetNum(GameConstants::Chunk::Size * GameConstants::Chunk::Size);
+	OutColumns.Reset(GameConstants::Chunk::Size * GameConstants::Chunk::Size);
 	OutEntities.Empty(); // FlatWorldGenerator doesn't generate entities
 
 	// const auto ShapeId = GameManager->ShapeRegistry->GetShapeIdByName(ShapeName);
@@ -21,15 +21,9 @@ void UFlatWorldGenerator::GenerateChunk(const FChunkPosition& Position,
 		for (int32 Y = 0; Y < GameConstants::Chunk::Size; ++Y)
 		{
 			const int32 Index = X + Y * GameConstants::Chunk::Size;
-			auto& Column = OutColumns[Index];
-
-			Column.Pieces.Add(FPiece{
-				Shape,
-				static_cast<unsigned short>(GroundHeight)
-			});
-			Column.Pieces.Add(FPiece{
-				EMaterial::Void,
-				static_cast<unsigned short>(GameConstants::Chunk::Height - GroundHeight)
+			OutColumns.SetColumn(Index, {
+				FPiece{Shape, static_cast<unsigned short>(GroundHeight)},
+				FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height - GroundHeight)}
 			});
 		}
 	}
@@ -4,7 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "WorldGenerator.h"
-#include "Bluevox/Chunk/Data/ChunkColumn.h"
+#include "Bluevox/Chunk/Data/ChunkColumnStorage.h"
 #include "Bluevox/Game/GameConstants.h"
 #include "Bluevox/Game/VoxelMaterial.h"
 #include "FlatWorldGenerator.generated.h"
@@ -27,7 +27,7 @@ public:
 	UPROPERTY(EditAnywhere)
 	EMaterial Shape;
 	
-	virtual void GenerateChunk(const FChunkPosition& Position, TArray<FChunkColumn>& OutColumns, TArray<struct FEntityRecord>& OutEntities) override;
+	virtual void GenerateChunk(const FChunkPosition& Position, FChunkColumnStorage& OutColumns, TArray<struct FEntityRecord>& OutEntities) override;
 
 	virtual void Serialize(FArchive& Ar) override;
 };
@@ -4,7 +4,7 @@
 #include "NoiseWorldGenerator.h"
 
 #include "Bluevox/Chunk/Data/ChunkData.h"
-#include "Bluevox/Chunk/Data/ChunkColumn.h"
+#include "Bluevox/Chunk/Data/ChunkColumnStorage.h"
 #include "Bluevox/Chunk/Data/Piece.h"
 #include "Bluevox/Chunk/Position/ChunkPosition.h"
 #include "Bluevox/Game/GameConstants.h"
@@ -300,9 +300,9 @@ void UNoiseWorldGenerator::BuildColumn(int32 GroundHeightLayers, int32 SeaLevel,
 	}
 }
 
-void UNoiseWorldGenerator::GenerateChunk(const FChunkPosition& Position, TArray<FChunkColumn>& OutColumns, TArray<FEntityRecord>& OutEntities)
+void UNoiseWorldGenerator::GenerateChunk(const FChunkPosition& Position, FChunkColumnStorage& OutColumns, TArray<FEntityRecord>& OutEntities)
 {
-	OutColumns.SetNum(GameConstants::Chunk::Size * GameConstants::Chunk::Size);
+	OutColumns.Reset(GameConstants::Chunk::Size * GameConstants::Chunk::Size);
 	OutEntities.Empty();
 
 	const int32 ChunkSize = GameConstants::Chunk::Size;
@@ -317,6 +317,10 @@ void UNoiseWorldGenerator::GenerateChunk(const FChunkPosition& Position, TArray<
 	TArray<FPlacedSpawn> PlacedSpawns;
 	PlacedSpawns.Reserve(64);
 
+	// Scratch column, copied into the chunk storage once built
+	TArray<FPiece> pieces;
+	pieces.Reserve(5);
+
 	for (int32 lx = 0; lx < ChunkSize; ++lx)
 	{
 		for (int32 ly = 0; ly < ChunkSize; ++ly)
@@ -365,9 +369,6 @@ void UNoiseWorldGenerator::GenerateChunk(const FChunkPosition& Position, TArray<
 			EBiome biome = EBiome::Plains;
 			ChooseBiome(temp01, moist01, bOcean, bMountain, groundH, biome);
 
-			TArray<FPiece> pieces;
-			pieces.Reserve(5);
-
 			// Compute local slope to decide if this column is a cliff (expose stone) or gentle (grass/dirt)
 			auto ComputeGroundH = [&](int32 X, int32 Y) -> int32
 			{
@@ -406,16 +407,15 @@ void UNoiseWorldGenerator::GenerateChunk(const FChunkPosition& Position, TArray<
 
 			BuildColumn(groundH, SeaLevel, biome, bIsCliff, bMountain, pieces);
 
-			const int32 idx = UChunkData::GetIndex(lx, ly);
-			OutColumns[idx] = FChunkColumn{ MoveTemp(pieces) };
+			const int32 idx = FChunkData::GetIndex(lx, ly);
+			OutColumns.SetColumn(idx, pieces);
 
 			// Instance spawning per column
 			if (bSpawnInstances && InstanceTypes.Num() > 0)
 			{
 				// Determine surface material (last piece that is not Void/Water)
 				EMaterial SurfaceMat = EMaterial::Void;
-				const TArray<FPiece>& ColPieces = OutColumns[idx].Pieces;
-				for (const FPiece& P : ColPieces)
+				for (const FPiece& P : pieces)
 				{
 					if (P.MaterialId != EMaterial::Void && P.MaterialId != EMaterial::Water)
 					{
@@ -157,5 +157,5 @@ protected:
 	void BuildColumn(int32 GroundHeightLayers, int32 SeaLevel, EBiome Biome, bool bIsCliff, bool bIsMountain, TArray<struct FPiece>& OutPieces) const;
 
 public:
-	virtual void GenerateChunk(const FChunkPosition& Position, TArray<FChunkColumn>& OutColumns, TArray<struct FEntityRecord>& OutEntities) override;
+	virtual void GenerateChunk(const FChunkPosition& Position, FChunkColumnStorage& OutColumns, TArray<struct FEntityRecord>& OutEntities) override;
 };
@@ -11,75 +11,67 @@
 #include "Bluevox/Game/GameConstants.h"
 
 void UTestWorldGenerator::GenerateThreeColumns(const FChunkPosition& Position,
-	TArray<FChunkColumn>& OutColumns) const
+	FChunkColumnStorage& OutColumns) const
 {
+	OutColumns.Reset(GameConstants::Chunk::Size * GameConstants::Chunk::Size);
+
 	for (int X = 0; X < GameConstants::Chunk::Size; ++X)
 	{
 		for (int Y = 0; Y < GameConstants::Chunk::Size; ++Y)
 		{
-			const int Index = UChunkData::GetIndex(X, Y);
-			OutColumns[Index] = FChunkColumn{
-							{
-								FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height)},
-							}
-			};
+			const int Index = FChunkData::GetIndex(X, Y);
+			OutColumns.SetColumn(Index, {
+				FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height)},
+			});
 		}
 	}
 
 	if (Position.X == 0 && Position.Y == 0)
 	{
-		OutColumns[UChunkData::GetIndex(0,0)] = FChunkColumn{
-					{
-						FPiece{EMaterial::Dirt, 10},
-						FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height - 10)}
-					}
-		};
+		OutColumns.SetColumn(FChunkData::GetIndex(0,0), {
+			FPiece{EMaterial::Dirt, 10},
+			FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height - 10)}
+		});
 	
-		OutColumns[UChunkData::GetIndex(1,0)] = FChunkColumn{
-						{
-							FPiece{EMaterial::Dirt, 5},
-							FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height - 5)}
-						}
-		};
+		OutColumns.SetColumn(FChunkData::GetIndex(1,0), {
+			FPiece{EMaterial::Dirt, 5},
+			FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height - 5)}
+		});
 	
-		OutColumns[UChunkData::GetIndex(0,1)] = FChunkColumn{
-				{
-					FPiece{EMaterial::Dirt, 1024},
-				}
-		};
+		OutColumns.SetColumn(FChunkData::GetIndex(0,1), {
+			FPiece{EMaterial::Dirt, 1024},
+		});
 	}
 }
 
 void UTestWorldGenerator::GenerateOneColumnTick(const FChunkPosition& Position,
-	TArray<FChunkColumn>& OutColumns) const
+	FChunkColumnStorage& OutColumns) const
 {
+	OutColumns.Reset(GameConstants::Chunk::Size * GameConstants::Chunk::Size);
+
 	for (int X = 0; X < GameConstants::Chunk::Size; ++X)
 	{
 		for (int Y = 0; Y < GameConstants::Chunk::Size; ++Y)
 		{
-			const int Index = UChunkData::GetIndex(X, Y);
-			OutColumns[Index] = FChunkColumn{
-								{
-									FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height)},
-								}
-			};
+			const int Index = FChunkData::GetIndex(X, Y);
+			OutColumns.SetColumn(Index, {
+				FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height)},
+			});
 		}
 	}
 
 	if (Position.X == 0 && Position.Y == 0)
 	{
-		OutColumns[UChunkData::GetIndex(0,0)] = FChunkColumn{
-						{
-							FPiece{EMaterial::Stone, 100},
-							FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height - 100)}
-						}
-		};
+		OutColumns.SetColumn(FChunkData::GetIndex(0,0), {
+			FPiece{EMaterial::Stone, 100},
+			FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height - 100)}
+		});
 	}
 }
 
-void UTestWorldGenerator::GenerateNoise4X4(const FChunkPosition& Position, TArray<FChunkColumn>& OutColumns) const
+void UTestWorldGenerator::GenerateNoise4X4(const FChunkPosition& Position, FChunkColumnStorage& OutColumns) const
 {
-	OutColumns.SetNum(GameConstants::Chunk::Size * GameConstants::Chunk::Size);
+	OutColumns.Reset(GameConstants::Chunk::Size * GameConstants::Chunk::Size);
 
 	constexpr auto DirtId = EMaterial::Dirt;
 	constexpr auto GrassId = EMaterial::Grass;
@@ -96,8 +88,7 @@ void UTestWorldGenerator::GenerateNoise4X4(const FChunkPosition& Position, TArra
 			{
 				if (X < 4 && Y < 4)
 				{
-					const auto Index = UChunkData::GetIndex(X, Y);
-					auto& Column = OutColumns[Index];
+					const auto Index = FChunkData::GetIndex(X, Y);
 
 					const auto WorldX = X + Position.X * GameConstants::Chunk::Size;
 					const auto WorldY = Y + Position.Y * GameConstants::Chunk::Size;
@@ -112,18 +103,18 @@ void UTestWorldGenerator::GenerateNoise4X4(const FChunkPosition& Position, TArra
 					const auto StoneHeight = Height - GrassHeight - DirtHeight;
 					const auto VoidHeight = GameConstants::Chunk::Height - Height;
 			
-					Column.Pieces.Emplace(StoneId, StoneHeight);
-					Column.Pieces.Emplace(DirtId, DirtHeight);
-					Column.Pieces.Emplace(GrassId, GrassHeight);
-					Column.Pieces.Emplace(EMaterial::Void, VoidHeight);
+					OutColumns.SetColumn(Index, {
+						FPiece{StoneId, static_cast<unsigned short>(StoneHeight)},
+						FPiece{DirtId, static_cast<unsigned short>(DirtHeight)},
+						FPiece{GrassId, static_cast<unsigned short>(GrassHeight)},
+						FPiece{EMaterial::Void, static_cast<unsigned short>(VoidHeight)}
+					});
 				} else
 				{
-					const int Index = UChunkData::GetIndex(X, Y);
-					OutColumns[Index] = FChunkColumn{
-						{
-							FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height)},
-						}
-					};
+					const int Index = FChunkData::GetIndex(X, Y);
+					OutColumns.SetColumn(Index, {
+						FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height)},
+					});
 				}
 			}
 		}
@@ -133,39 +124,35 @@ void UTestWorldGenerator::GenerateNoise4X4(const FChunkPosition& Position, TArra
 		{
 			for (int Y = 0; Y < GameConstants::Chunk::Size; ++Y)
 			{
-				const int Index = UChunkData::GetIndex(X, Y);
-				OutColumns[Index] = FChunkColumn{
-					{
-						FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height)},
-					}
-				};
+				const int Index = FChunkData::GetIndex(X, Y);
+				OutColumns.SetColumn(Index, {
+					FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height)},
+				});
 			}
 		}
 	}
 }
 
 void UTestWorldGenerator::GenerateTickAlwaysShape(const FChunkPosition& Position,
-	TArray<FChunkColumn>& OutColumns) const
+	FChunkColumnStorage& OutColumns) const
 {
-	OutColumns.SetNum(GameConstants::Chunk::Size * GameConstants::Chunk::Size);
+	OutColumns.Reset(GameConstants::Chunk::Size * GameConstants::Chunk::Size);
 	
 	for (int X = 0; X < GameConstants::Chunk::Size; ++X)
 	{
 		for (int Y = 0; Y < GameConstants::Chunk::Size; ++Y)
 		{
-			const int Index = UChunkData::GetIndex(X, Y);
-			OutColumns[Index] = FChunkColumn{
-								{
-									FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height)},
-								}
-			};
+			const int Index = FChunkData::GetIndex(X, Y);
+			OutColumns.SetColumn(Index, {
+				FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height)},
+			});
 		}
 	}
 
 	// if (Position.X == 0 && Position.Y == 0)
 	// {
 	// 	
-	// 	OutColumns[UChunkData::GetIndex(0,0)] = FChunkColumn{
+	// 	OutColumns[FChunkData::GetIndex(0,0)] = FChunkColumn{
 	// 					{
 	// 						FPiece{TickAlwaysShape, 1},
 	// 						FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height - 1)}
@@ -175,20 +162,18 @@ void UTestWorldGenerator::GenerateTickAlwaysShape(const FChunkPosition& Position
 }
 
 void UTestWorldGenerator::GenerateTickOnLoadShape(const FChunkPosition& Position,
-	TArray<FChunkColumn>& OutColumns) const
+	FChunkColumnStorage& OutColumns) const
 {
-	OutColumns.SetNum(GameConstants::Chunk::Size * GameConstants::Chunk::Size);
+	OutColumns.Reset(GameConstants::Chunk::Size * GameConstants::Chunk::Size);
 	
 	for (int X = 0; X < GameConstants::Chunk::Size; ++X)
 	{
 		for (int Y = 0; Y < GameConstants::Chunk::Size; ++Y)
 		{
-			const int Index = UChunkData::GetIndex(X, Y);
-			OutColumns[Index] = FChunkColumn{
-									{
-										FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height)},
-									}
-			};
+			const int Index = FChunkData::GetIndex(X, Y);
+			OutColumns.SetColumn(Index, {
+				FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height)},
+			});
 		}
 	}
 
@@ -196,7 +181,7 @@ void UTestWorldGenerator::GenerateTickOnLoadShape(const FChunkPosition& Position
 	// {
 	// 	const auto TickOnLoadShape = GameManager->ShapeRegistry->GetShapeIdByName(GameConstants::Textures::GShape_Test_TickOnLoad);
 	// 	
-	// 	OutColumns[UChunkData::GetIndex(0,0)] = FChunkColumn{
+	// 	OutColumns[FChunkData::GetIndex(0,0)] = FChunkColumn{
 	// 						{
 	// 							FPiece{TickOnLoadShape, 1},
 	// 							FPiece{0, static_cast<unsigned short>(GameConstants::Chunk::Height - 1)}
@@ -206,20 +191,18 @@ void UTestWorldGenerator::GenerateTickOnLoadShape(const FChunkPosition& Position
 }
 
 void UTestWorldGenerator::GenerateTickOnNeighborUpdateShape(const FChunkPosition& Position,
-	TArray<FChunkColumn>& OutColumns) const
+	FChunkColumnStorage& OutColumns) const
 {
-	OutColumns.SetNum(GameConstants::Chunk::Size * GameConstants::Chunk::Size);
+	OutColumns.Reset(GameConstants::Chunk::Size * GameConstants::Chunk::Size);
 	
 	for (int X = 0; X < GameConstants::Chunk::Size; ++X)
 	{
 		for (int Y = 0; Y < GameConstants::Chunk::Size; ++Y)
 		{
-			const int Index = UChunkData::GetIndex(X, Y);
-			OutColumns[Index] = FChunkColumn{
-									{
-										FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height)},
-									}
-			};
+			const int Index = FChunkData::GetIndex(X, Y);
+			OutColumns.SetColumn(Index, {
+				FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height)},
+			});
 		}
 	}
 
@@ -228,23 +211,18 @@ void UTestWorldGenerator::GenerateTickOnNeighborUpdateShape(const FChunkPosition
 		const auto Dirt = EMaterial::Dirt;
 		// const auto TickOnNeighborUpdate = GameManager->ShapeRegistry->GetShapeIdByName(GameConstants::Textures::GShape_Test_TickOnNeighborUpdate);
 		
-		OutColumns[UChunkData::GetIndex(0,0)] = FChunkColumn{
-							{
-								FPiece{Dirt, 1},
-								FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height - 1)}
-							}
-		};
-		OutColumns[UChunkData::GetIndex(0,1)] = FChunkColumn{
-									{
-										FPiece{Dirt, 1},
-										FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height - 1)}
-									}};
-		OutColumns[UChunkData::GetIndex(1,1)] = FChunkColumn{
-								{
-									FPiece{Dirt, 1},
-									FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height - 1)}
-								}
-		};
+		OutColumns.SetColumn(FChunkData::GetIndex(0,0), {
+			FPiece{Dirt, 1},
+			FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height - 1)}
+		});
+		OutColumns.SetColumn(FChunkData::GetIndex(0,1), {
+			FPiece{Dirt, 1},
+			FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height - 1)}
+		});
+		OutColumns.SetColumn(FChunkData::GetIndex(1,1), {
+			FPiece{Dirt, 1},
+			FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height - 1)}
+		});
 	}
 }
 
@@ -255,7 +233,7 @@ UTestWorldGenerator::UTestWorldGenerator()
 }
 
 void UTestWorldGenerator::GenerateChunk(const FChunkPosition& Position,
-                                        TArray<FChunkColumn>& OutColumns,
+                                        FChunkColumnStorage& OutColumns,
                                         TArray<FEntityRecord>& OutEntities)
 {
 	// GenerateTickAlwaysShape(Position, OutColumns);
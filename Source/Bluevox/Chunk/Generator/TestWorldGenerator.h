@@ -18,20 +18,20 @@ class BLUEVOX_API UTestWorldGenerator : public UWorldGenerator
 	UPROPERTY()
 	UFastNoiseWrapper* Noise;
 
-	void GenerateThreeColumns(const FChunkPosition& Position, TArray<FChunkColumn>& OutColumns) const;
+	void GenerateThreeColumns(const FChunkPosition& Position, FChunkColumnStorage& OutColumns) const;
 
-	void GenerateOneColumnTick(const FChunkPosition& Position, TArray<FChunkColumn>& OutColumns) const;
+	void GenerateOneColumnTick(const FChunkPosition& Position, FChunkColumnStorage& OutColumns) const;
 
-	void GenerateNoise4X4(const FChunkPosition& Position, TArray<FChunkColumn>& OutColumns) const;
+	void GenerateNoise4X4(const FChunkPosition& Position, FChunkColumnStorage& OutColumns) const;
 
-	void GenerateTickAlwaysShape(const FChunkPosition& Position, TArray<FChunkColumn>& OutColumns) const;
+	void GenerateTickAlwaysShape(const FChunkPosition& Position, FChunkColumnStorage& OutColumns) const;
 
-	void GenerateTickOnLoadShape(const FChunkPosition& Position, TArray<FChunkColumn>& OutColumns) const;
+	void GenerateTickOnLoadShape(const FChunkPosition& Position, FChunkColumnStorage& OutColumns) const;
 
-	void GenerateTickOnNeighborUpdateShape(const FChunkPosition& Position, TArray<FChunkColumn>& OutColumns) const;
+	void GenerateTickOnNeighborUpdateShape(const FChunkPosition& Position, FChunkColumnStorage& OutColumns) const;
 	
 public:
 	UTestWorldGenerator();
 
-	virtual void GenerateChunk(const FChunkPosition& Position, TArray<FChunkColumn>& OutColumns, TArray<struct FEntityRecord>& OutEntities) override;
+	virtual void GenerateChunk(const FChunkPosition& Position, FChunkColumnStorage& OutColumns, TArray<struct FEntityRecord>& OutEntities) override;
 };
@@ -13,21 +13,18 @@ UWorldGenerator* UWorldGenerator::Init(AGameManager* InGameManager)
 }
 
 void UWorldGenerator::GenerateChunk(const FChunkPosition& Position,
-                                    TArray<FChunkColumn>& OutColumns,
+                                    FChunkColumnStorage& OutColumns,
                                     TArray<FEntityRecord>& OutEntities)
 {
-	OutColumns.SetNum(GameConstants::Chunk::Size * GameConstants::Chunk::Size);
+	OutColumns.Reset(GameConstants::Chunk::Size * GameConstants::Chunk::Size);
 
 	for (int32 X = 0; X < GameConstants::Chunk::Size; ++X)
 	{
 		for (int32 Y = 0; Y < GameConstants::Chunk::Size; ++Y)
 		{
-			const int32 Index = UChunkData::GetIndex(X, Y);
-			auto& Column = OutColumns[Index];
-
-			Column.Pieces.Add(FPiece{
-				EMaterial::Void,
-				static_cast<unsigned short>(GameConstants::Chunk::Height)
+			const int32 Index = FChunkData::GetIndex(X, Y);
+			OutColumns.SetColumn(Index, {
+				FPiece{EMaterial::Void, static_cast<unsigned short>(GameConstants::Chunk::Height)}
 			});
 		}
 	}
@@ -3,13 +3,13 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "Bluevox/Chunk/Data/ChunkColumn.h"
+#include "Bluevox/Chunk/Data/ChunkColumnStorage.h"
 #include "UObject/Object.h"
 #include "WorldGenerator.generated.h"
 
 struct FChunkPosition;
 class AGameManager;
-class UChunkData;
+class FChunkData;
 
 /**
  * 
@@ -26,5 +26,5 @@ protected:
 public:
 	UWorldGenerator* Init(AGameManager* InGameManager);
 
-	virtual void GenerateChunk(const FChunkPosition& Position, TArray<FChunkColumn>& OutColumns, TArray<struct FEntityRecord>& OutEntities);
+	virtual void GenerateChunk(const FChunkPosition& Position, FChunkColumnStorage& OutColumns, TArray<struct FEntityRecord>& OutEntities);
 };
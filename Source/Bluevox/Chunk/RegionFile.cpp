@@ -1,4 +1,4 @@
-#include "RegionFile.h"
+﻿#include "RegionFile.h"
 
 #include "LogChunk.h"
 #include "Bluevox/Game/GameConstants.h"
@@ -9,11 +9,12 @@
 #include "Serialization/ArchiveSaveCompressedProxy.h"
 #include "Serialization/BufferArchive.h"
 
-void FRegionFile::Th_SaveChunk(const FLocalChunkPosition& Position, UChunkData* ChunkData)
+void FRegionFile::Th_SaveChunk(const FLocalChunkPosition& Position, const FChunkSnapshot& Snapshot,
+	const TArray<FEntityRecord>& Entities)
 {
 	UE_LOG(LogChunk, Verbose, TEXT("Saving chunk data for position %s in disk."), *Position.ToString());
 
-	if (!IsValid(ChunkData))
+	if (!Snapshot.IsValid())
 	{
 		UE_LOG(LogChunk, Error, TEXT("Chunk data is null for position %s."), *Position.ToString());
 		return;
@@ -22,18 +23,13 @@ void FRegionFile::Th_SaveChunk(const FLocalChunkPosition& Position, UChunkData*
 	const uint32 Index = Position.X + Position.Y * GameConstants::Region::Size;
 
 	FBufferArchive Uncompressed;
-	Uncompressed << ChunkData->Columns;
+	int32 FileVersion = GameConstants::Chunk::File::FileVersion;
+	Uncompressed << FileVersion;
+	Snapshot.Columns->Save(Uncompressed);
 
-	// Serialize entities (flatten TSparseArray)
-	TArray<FEntityRecord> EntitiesArray;
-	EntitiesArray.Reserve(ChunkData->Entities.Num());
-	for (const FEntityRecord& Rec : ChunkData->Entities)
-	{
-		EntitiesArray.Add(Rec);
-	}
-	int32 NumEntities = EntitiesArray.Num();
+	int32 NumEntities = Entities.Num();
 	Uncompressed << NumEntities;
-	for (FEntityRecord& Rec : EntitiesArray)
+	for (FEntityRecord Rec : Entities)
 	{
 		Uncompressed << Rec;
 	}
@@ -55,14 +51,14 @@ void FRegionFile::Th_SaveChunk(const FLocalChunkPosition& Position, UChunkData*
 	}
 }
 
-bool FRegionFile::Th_LoadChunk(const FLocalChunkPosition& Position, TArray<FChunkColumn>& OutColumns,
+bool FRegionFile::Th_LoadChunk(const FLocalChunkPosition& Position, FChunkColumnStorage& OutColumns,
                                 TArray<FEntityRecord>& OutEntities)
 {
 	const uint32 Index = Position.X + Position.Y * GameConstants::Region::Size;
 
 	TArray<uint8> Compressed;
 	if (!Th_ReadSegment(Index, Compressed)) return false;
-	if (Compressed.Num() == 0) { OutColumns.Reset(); return false; }
+	if (Compressed.Num() == 0) { OutColumns.Empty(); return false; }
 
 	FArchiveLoadCompressedProxy Decompressor(Compressed, NAME_Zlib);
 	if (Decompressor.GetError())
@@ -82,7 +78,18 @@ bool FRegionFile::Th_LoadChunk(const FLocalChunkPosition& Position, TArray<FChun
 	}
 
 	FMemoryReader Reader(Uncompressed, true);
-	Reader << OutColumns;
+	int32 FileVersion = 0;
+	Reader << FileVersion;
+	if (FileVersion == GameConstants::Chunk::File::FileVersion)
+	{
+		Reader << OutColumns;
+	}
+	else
+	{
+		// Version 1 chunks have no header, that int was the column count of the unpacked layout
+		Reader.Seek(0);
+		OutColumns.LoadUnpacked(Reader);
+	}
 
 	// Load entities
 	OutEntities.Empty();
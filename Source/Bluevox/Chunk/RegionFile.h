@@ -3,12 +3,13 @@
 #include "CoreMinimal.h"
 #include "Bluevox/Game/WorldSave.h"
 #include "Bluevox/Utils/SegmentedFile/SegmentedFile.h"
-#include "Data/ChunkColumn.h"
+#include "Data/ChunkColumnStorage.h"
+#include "Data/ChunkSnapshot.h"
 #include "Bluevox/Entity/EntityTypes.h"
 
 struct FLocalChunkPosition;
 struct FLocalPosition;
-class UChunkData;
+class FChunkData;
 
 struct FRegionFile : FSegmentedFile
 {
@@ -16,9 +17,11 @@ struct FRegionFile : FSegmentedFile
 	{
 	}
 
-	void Th_SaveChunk(const FLocalChunkPosition& Position, UChunkData* ChunkData);
+	// Entities are passed already flattened, they are only safe to read on the game thread
+	void Th_SaveChunk(const FLocalChunkPosition& Position, const FChunkSnapshot& Snapshot,
+	                  const TArray<FEntityRecord>& Entities);
 
-	bool Th_LoadChunk(const FLocalChunkPosition& Position, TArray<FChunkColumn>& OutColumns,
+	bool Th_LoadChunk(const FLocalChunkPosition& Position, FChunkColumnStorage& OutColumns,
 	                  TArray<FEntityRecord>& OutEntities);
 
 	static TSharedPtr<FRegionFile> NewFromDisk(const FString& WorldName, const FRegionPosition& RegionPosition);
@@ -0,0 +1,188 @@
+﻿#include "ChunkPipeline.h"
+
+#include "ChunkTaskManager.h"
+#include "LogVirtualMapTaskManager.h"
+#include "Bluevox/Game/GameManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	const TCHAR* StageNames[] = {
+		TEXT("Load"), TEXT("Generate"), TEXT("Register"), TEXT("Spawn"), TEXT("Wait"), TEXT("Mesh"), TEXT("Commit")
+	};
+	static_assert(UE_ARRAY_COUNT(StageNames) == static_cast<uint8>(EChunkStage::Num));
+
+	UChunkTaskManager* FindChunkTaskManager(UWorld* World)
+	{
+		const AGameManager* GameManager = Cast<AGameManager>(UGameplayStatics::GetActorOfClass(World, AGameManager::StaticClass()));
+		return GameManager ? GameManager->ChunkTaskManager : nullptr;
+	}
+}
+
+void FChunkPipeline::Wait(const FChunkPosition& Position, const TConstArrayView<FChunkPosition> MissingData,
+	const bool bMissingActor)
+{
+	RemoveWait(Position);
+	WaitingSince.FindOrAdd(Position, FPlatformTime::Seconds());
+
+	FWait& NewWait = Waits.Add(Position);
+	NewWait.Data = TArray<FChunkPosition>(MissingData);
+	NewWait.bActor = bMissingActor;
+	for (const FChunkPosition& Missing : MissingData)
+	{
+		DataDependents.FindOrAdd(Missing).Add(Position);
+	}
+	if (bMissingActor)
+	{
+		ActorDependents.Add(Position);
+	}
+}
+
+void FChunkPipeline::Ready(const FChunkPosition& Position)
+{
+	double Since;
+	Record(EChunkStage::Wait, WaitingSince.RemoveAndCopyValue(Position, Since) ? FPlatformTime::Seconds() - Since : 0);
+}
+
+void FChunkPipeline::CompleteData(const FChunkPosition& Position, TArray<FChunkPosition>& OutWoken)
+{
+	TArray<FChunkPosition> Dependents;
+	if (!DataDependents.RemoveAndCopyValue(Position, Dependents))
+	{
+		return;
+	}
+
+	// Woken on the first prerequisite done, checking all of them again is what tells if it was the last
+	for (const FChunkPosition& Dependent : Dependents)
+	{
+		RemoveWait(Dependent);
+		OutWoken.AddUnique(Dependent);
+	}
+}
+
+void FChunkPipeline::CompleteSpawn(const FChunkPosition& Position, TArray<FChunkPosition>& OutWoken)
+{
+	if (ActorDependents.Contains(Position))
+	{
+		RemoveWait(Position);
+		OutWoken.AddUnique(Position);
+	}
+}
+
+void FChunkPipeline::Forget(const FChunkPosition& Position)
+{
+	RemoveWait(Position);
+	WaitingSince.Remove(Position);
+}
+
+void FChunkPipeline::Record(const EChunkStage Stage, const double Seconds)
+{
+	Histograms[static_cast<uint8>(Stage)].Add(Seconds * 1000.0);
+}
+
+void FChunkPipeline::LogStats() const
+{
+	UE_LOG(LogVirtualMapTaskManager, Display, TEXT("Chunk pipeline: %d meshes waiting on %d chunks"), Waits.Num(), DataDependents.Num());
+	for (uint8 Stage = 0; Stage < static_cast<uint8>(EChunkStage::Num); ++Stage)
+	{
+		const FChunkStageHistogram& Histogram = Histograms[Stage];
+		UE_LOG(LogVirtualMapTaskManager, Display, TEXT("  %-8s %8llu  avg %8.2f ms  p50 <%6.0f ms  p99 <%6.0f ms  max %8.2f ms"),
+			StageNames[Stage], Histogram.Count, Histogram.GetAverage(),
+			Histogram.GetPercentile(0.5), Histogram.GetPercentile(0.99), Histogram.Max);
+	}
+}
+
+bool FChunkPipeline::WriteCsv(const FString& Path) const
+{
+	FString Csv = TEXT("Stage,Count,AvgMs,P50Ms,P99Ms,MaxMs") + FChunkStageHistogram::GetCsvHeader(TEXT("ms"));
+	Csv += LINE_TERMINATOR;
+
+	for (uint8 Stage = 0; Stage < static_cast<uint8>(EChunkStage::Num); ++Stage)
+	{
+		const FChunkStageHistogram& Histogram = Histograms[Stage];
+		Csv += FString::Printf(TEXT("%s,%llu,%.3f,%.0f,%.0f,%.3f"), StageNames[Stage], Histogram.Count,
+			Histogram.GetAverage(), Histogram.GetPercentile(0.5), Histogram.GetPercentile(0.99), Histogram.Max);
+		Histogram.AppendCsvBuckets(Csv);
+		Csv += LINE_TERMINATOR;
+	}
+
+	return FFileHelper::SaveStringToFile(Csv, *Path);
+}
+
+void FChunkPipeline::ResetStats()
+{
+	for (FChunkStageHistogram& Histogram : Histograms)
+	{
+		Histogram = FChunkStageHistogram();
+	}
+}
+
+void FChunkPipeline::RemoveWait(const FChunkPosition& Position)
+{
+	FWait Removed;
+	if (!Waits.RemoveAndCopyValue(Position, Removed))
+	{
+		return;
+	}
+
+	for (const FChunkPosition& Missing : Removed.Data)
+	{
+		if (TArray<FChunkPosition>* Dependents = DataDependents.Find(Missing))
+		{
+			Dependents->RemoveSwap(Position);
+			if (Dependents->IsEmpty())
+			{
+				DataDependents.Remove(Missing);
+			}
+		}
+	}
+
+	if (Removed.bActor)
+	{
+		ActorDependents.Remove(Position);
+	}
+}
+
+static FAutoConsoleCommand CmdChunkPipelineStats(
+	TEXT("game.chunk.pipeline.stats"),
+	TEXT("Logs how long each stage of the chunk pipeline takes, from load to commit. Pass reset to start over"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UChunkTaskManager* TaskManager = FindChunkTaskManager(World);
+		if (!TaskManager)
+		{
+			UE_LOG(LogVirtualMapTaskManager, Warning, TEXT("No world is loaded"));
+			return;
+		}
+
+		TaskManager->GetPipeline().LogStats();
+		if (Args.Num() > 0 && Args[0] == TEXT("reset"))
+		{
+			TaskManager->GetPipeline().ResetStats();
+		}
+	}));
+
+static FAutoConsoleCommand CmdChunkPipelineCsv(
+	TEXT("game.chunk.pipeline.csv"),
+	TEXT("Writes the latency histogram of each chunk pipeline stage to a CSV file, Saved/Profiling/ChunkPipeline.csv by default"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const UChunkTaskManager* TaskManager = FindChunkTaskManager(World);
+		if (!TaskManager)
+		{
+			UE_LOG(LogVirtualMapTaskManager, Warning, TEXT("No world is loaded"));
+			return;
+		}
+
+		const FString Path = Args.Num() > 0 ? Args[0] : FPaths::ProfilingDir() / TEXT("ChunkPipeline.csv");
+		if (TaskManager->GetPipeline().WriteCsv(Path))
+		{
+			UE_LOG(LogVirtualMapTaskManager, Display, TEXT("Chunk pipeline histograms written to %s"), *Path);
+		}
+		else
+		{
+			UE_LOG(LogVirtualMapTaskManager, Warning, TEXT("Failed to write the chunk pipeline histograms to %s"), *Path);
+		}
+	}));
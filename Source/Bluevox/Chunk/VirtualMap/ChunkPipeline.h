@@ -0,0 +1,97 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Bluevox/Chunk/Position/ChunkPosition.h"
+#include "Bluevox/Utils/LatencyHistogram.h"
+
+enum class EChunkStage : uint8
+{
+	// Reading the chunk from its region file
+	Load,
+
+	// Generating a chunk its region file doesn't have
+	Generate,
+
+	// From the load job done to its data registered on the game thread
+	Register,
+
+	// From the data registered to the chunk actor spawned
+	Spawn,
+
+	// From a render scheduled to the data of the chunk and its neighbours and its actor all there
+	Wait,
+
+	// From the render dispatched to its result back on the game thread
+	Mesh,
+
+	// Handing the result to the chunk components
+	Commit,
+
+	Num
+};
+
+// In milliseconds, the last bucket is 32 s and above
+using FChunkStageHistogram = TLatencyHistogram<17>;
+
+/**
+ * The lifecycle of each chunk (load, generate, register, spawn, mesh and commit) as a dependency graph. A mesh depends
+ * on the data of its chunk and its 4 neighbours and on its actor: it waits on the ones missing and is woken when one
+ * of them completes, nothing polls them every tick. Also keeps how long each stage takes. Game thread only.
+ */
+class FChunkPipeline
+{
+public:
+	// The mesh of Position waits on the data of MissingData and, if bMissingActor, on its actor
+	void Wait(const FChunkPosition& Position, TConstArrayView<FChunkPosition> MissingData, const bool bMissingActor);
+
+	bool IsWaiting(const FChunkPosition& Position) const
+	{
+		return Waits.Contains(Position);
+	}
+
+	// The mesh of Position has all it waited on, records how long it did
+	void Ready(const FChunkPosition& Position);
+
+	// Data of Position registered, OutWoken gets the meshes that waited on it, they have to be checked again
+	void CompleteData(const FChunkPosition& Position, TArray<FChunkPosition>& OutWoken);
+
+	// Actor of Position spawned, OutWoken gets its mesh if it waited on it
+	void CompleteSpawn(const FChunkPosition& Position, TArray<FChunkPosition>& OutWoken);
+
+	// The mesh of Position is no longer wanted
+	void Forget(const FChunkPosition& Position);
+
+	void Record(const EChunkStage Stage, const double Seconds);
+
+	void LogStats() const;
+
+	// A row per stage, the count of each bucket in its columns
+	bool WriteCsv(const FString& Path) const;
+
+	void ResetStats();
+
+private:
+	struct FWait
+	{
+		TArray<FChunkPosition> Data;
+
+		bool bActor = false;
+	};
+
+	// Mesh to what it waits on
+	TMap<FChunkPosition, FWait> Waits;
+
+	// Chunk to the meshes waiting on its data
+	TMap<FChunkPosition, TArray<FChunkPosition>> DataDependents;
+
+	// Meshes waiting on their own actor
+	TSet<FChunkPosition> ActorDependents;
+
+	// Waits woken and not ready yet keep their start here, so waiting again doesn't reset it
+	TMap<FChunkPosition, double> WaitingSince;
+
+	TStaticArray<FChunkStageHistogram, static_cast<uint8>(EChunkStage::Num)> Histograms;
+
+	// Drops the edges of the mesh of Position
+	void RemoveWait(const FChunkPosition& Position);
+};
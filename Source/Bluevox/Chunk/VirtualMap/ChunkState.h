@@ -7,9 +7,33 @@ enum class EChunkState : uint8
 	Visible = 1 << 0 UMETA(DisplayName = "Visible"),
 	Collision = 1 << 1 UMETA(DisplayName = "Collision"),
 
+	// Level of detail of the mesh in 2 bits, see ChunkStateUtils::GetLod
+	Lod1 = 1 << 2 UMETA(DisplayName = "LOD 1"),
+	Lod2 = 2 << 2 UMETA(DisplayName = "LOD 2"),
+	Lod3 = Lod1 | Lod2 UMETA(DisplayName = "LOD 3"),
+
 	Live = Visible | Collision UMETA(DisplayName = "Live"),
 	RemoteLive = Collision UMETA(DisplayName = "Remote Live"),
 	LoadOnly = None UMETA(DisplayName = "Load Only"),
 };
 
 ENUM_CLASS_FLAGS(EChunkState);
+
+namespace ChunkStateUtils
+{
+	constexpr int32 LodShift = 2;
+
+	constexpr int32 MaxLod = 3;
+
+	// 0 is full resolution, each level merges twice as many columns per side
+	inline int32 GetLod(const EChunkState State)
+	{
+		return static_cast<uint8>(State) >> LodShift & MaxLod;
+	}
+
+	inline EChunkState WithLod(const EChunkState State, const int32 Lod)
+	{
+		const uint8 Flags = static_cast<uint8>(State) & ~(MaxLod << LodShift);
+		return static_cast<EChunkState>(Flags | FMath::Clamp(Lod, 0, MaxLod) << LodShift);
+	}
+}
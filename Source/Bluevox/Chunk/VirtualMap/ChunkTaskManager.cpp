@@ -6,6 +6,7 @@
 #include "LogVirtualMapTaskManager.h"
 #include "VirtualMap.h"
 #include "Bluevox/Chunk/Chunk.h"
+#include "Bluevox/Chunk/ChunkMeshCache.h"
 #include "Bluevox/Chunk/ChunkRegistry.h"
 #include "Bluevox/Chunk/RegionFile.h"
 #include "Bluevox/Chunk/Data/ChunkData.h"
@@ -32,18 +33,11 @@ void UChunkTaskManager::Sv_ProcessPendingNetSend(const FPendingNetSendChunks& Pe
 			continue;
 		}
 
-		UChunkData* ChunkData = GameManager->ChunkRegistry->Th_GetChunkData(ChunkPosition);
-		// Flatten entities to an array for network
-		TArray<FEntityRecord> EntitiesArray;
-		EntitiesArray.Reserve(ChunkData->Entities.Num());
-		for (const FEntityRecord& Rec : ChunkData->Entities)
-		{
-			EntitiesArray.Add(Rec);
-		}
+		FChunkData* ChunkData = GameManager->ChunkRegistry->Th_GetChunkData(ChunkPosition);
 		DataToSend.Add(FChunkDataWithPosition{
 			ChunkPosition,
-			ChunkData->Columns,
-			MoveTemp(EntitiesArray)
+			ChunkData->Th_GetSnapshot().Columns,
+			ChunkData->GetEntityRecords()
 		});
 	}
 
@@ -62,7 +56,6 @@ void UChunkTaskManager::HandleChunkDataNetworkPacket(UChunkDataNetworkPacket* Pa
 {
 	const auto ChunkRegistry = GameManager->ChunkRegistry;
 	UE_LOG(LogVirtualMapTaskManager, Verbose, TEXT("Handling chunk data network packet with %d chunks"), Packet->Data.Num());
-	const auto TickManager = GameManager->TickManager;
 	for (auto& ChunkData : Packet->Data)
 	{
 		const auto ChunkPosition = ChunkData.Position;
@@ -88,18 +81,9 @@ void UChunkTaskManager::HandleChunkDataNetworkPacket(UChunkDataNetworkPacket* Pa
 			continue;
 		}
 
-		auto* ChunkDataObject = NewObject<UChunkData>(ChunkRegistry);
-		ChunkDataObject->Init(GameManager, ChunkPosition, MoveTemp(ChunkData.Columns), MoveTemp(ChunkData.Entities));
-		ChunkRegistry->Th_RegisterChunk(ChunkPosition, ChunkDataObject);
-
-		// Prevent stuttering the game
-		TickManager->Th_ScheduleFn([this, ChunkPosition, ChunkRegistry]
-		{
-			if (!ProcessingUnload.Contains(ChunkPosition))
-			{
-				ChunkRegistry->SpawnChunk(ChunkPosition);
-			}
-		});
+		ChunkRegistry->Th_RegisterChunk(ChunkPosition, ChunkData.Columns.ToSharedRef(), MoveTemp(ChunkData.Entities));
+		CompleteChunkData(ChunkPosition);
+		ScheduleSpawn(ChunkPosition);
 	}
 }
 
@@ -122,28 +106,63 @@ void UChunkTaskManager::ScheduleLoad(const TSet<FChunkPosition>& ChunksToLoad)
 		} else
 		{
 			ProcessingLoad.Add(ChunkPosition, true);
+			const FJobCancellationToken Token = LoadTokens.Add(ChunkPosition);
 			
-			GameManager->TickManager->RunAsyncThen([this, ChunkPosition]
+			GameManager->TickManager->RunJobThen(GetLoadLane(ChunkPosition), ETickCategory::ChunkLoad, Token, [this, ChunkPosition, Token]
 			{
 				FLoadResult LoadResult;
+				const double StartedAt = FPlatformTime::Seconds();
 				LoadResult.bSuccess = GameManager->ChunkRegistry->Th_FetchChunkDataFromDisk(ChunkPosition, LoadResult.Columns, LoadResult.Entities);
+				LoadResult.LoadSeconds = FPlatformTime::Seconds() - StartedAt;
+
+				// Generating is the expensive part, don't for a chunk already walked away from
+				if (Token.IsCancelled())
+				{
+					LoadResult.FinishedAt = FPlatformTime::Seconds();
+					return MoveTemp(LoadResult);
+				}
 
 				if (!LoadResult.bSuccess)
 				{
 					// TODO would re-generate chunk if fail to load from disk, is that a good idea?
 					GameManager->WorldSave->WorldGenerator->GenerateChunk(ChunkPosition, LoadResult.Columns, LoadResult.Entities);
+					LoadResult.GenerateSeconds = FPlatformTime::Seconds() - StartedAt - LoadResult.LoadSeconds;
 				}
 
+				LoadResult.Columns.Intern();
+
+				LoadResult.FinishedAt = FPlatformTime::Seconds();
 				return MoveTemp(LoadResult);
-			}, [ChunkPosition, this] (FLoadResult&& Result)
+			}, [ChunkPosition, this, Token] (FLoadResult&& Result)
 			{
 				UE_LOG(LogVirtualMapTaskManager, Verbose, TEXT("Processing load for chunk %s"), *ChunkPosition.ToString());
 
+				// Skipped or stopped half way, but wanted again meanwhile. Its result is of no use, load it again
+				if (Token.IsCancelled() && ProcessingLoad.FindRef(ChunkPosition) == true)
+				{
+					ProcessingLoad.Remove(ChunkPosition);
+					LoadTokens.Remove(ChunkPosition);
+					ScheduleLoad({ ChunkPosition });
+					return;
+				}
+
 				if (ProcessingLoad.FindRef(ChunkPosition) == true)
 				{
-					const auto ChunkData = NewObject<UChunkData>(GameManager->ChunkRegistry)->Init(
-     					GameManager, ChunkPosition, MoveTemp(Result.Columns), MoveTemp(Result.Entities));
-					GameManager->ChunkRegistry->Th_RegisterChunk(ChunkPosition, ChunkData);
+					FChunkData* ChunkData = GameManager->ChunkRegistry->Th_RegisterChunk(
+						ChunkPosition, MakeShared<FChunkColumnStorage, ESPMode::ThreadSafe>(MoveTemp(Result.Columns)), MoveTemp(Result.Entities));
+					if (Result.bSuccess)
+					{
+						// Read from its region file, unloading it untouched doesn't have to write it back
+						ChunkData->SavedChanges = ChunkData->Changes;
+					}
+
+					Pipeline.Record(EChunkStage::Load, Result.LoadSeconds);
+					if (!Result.bSuccess)
+					{
+						Pipeline.Record(EChunkStage::Generate, Result.GenerateSeconds);
+					}
+					Pipeline.Record(EChunkStage::Register, FPlatformTime::Seconds() - Result.FinishedAt);
+					CompleteChunkData(ChunkPosition);
 
 					if (PendingPacketsByPosition.Contains(ChunkPosition))
 					{
@@ -164,15 +183,7 @@ void UChunkTaskManager::ScheduleLoad(const TSet<FChunkPosition>& ChunksToLoad)
 						PendingPacketsByPosition.Remove(ChunkPosition);
 					}
 
-					// Prevent spawn from stuttering game
-					GameManager->TickManager->Th_ScheduleFn(
-						[ChunkPosition, this]
-						{
-							if (!ProcessingUnload.Contains(ChunkPosition))
-							{
-								GameManager->ChunkRegistry->SpawnChunk(ChunkPosition);	
-							}
-						});
+					ScheduleSpawn(ChunkPosition);
 				}
 
 				// We canceled the load, but it's automatically added to the ChunkRegistry, so we have to undo this
@@ -182,6 +193,7 @@ void UChunkTaskManager::ScheduleLoad(const TSet<FChunkPosition>& ChunksToLoad)
 				}
 				
 				ProcessingLoad.Remove(ChunkPosition);
+				LoadTokens.Remove(ChunkPosition);
 			});
 		}
 		
@@ -202,6 +214,7 @@ void UChunkTaskManager::ScheduleRender(const TSet<FChunkPosition>& ChunksToRende
 		if (ProcessingUnload.FindRef(ChunkPosition) == false)
 		{
 			PendingRender.Add(ChunkPosition);
+			QueueRenderIfReady(ChunkPosition);
 		}
 		else
 		{
@@ -219,6 +232,7 @@ void UChunkTaskManager::ScheduleRenderForced(const TSet<FChunkPosition>& ChunksT
 		{
 			PendingRender.Add(ChunkPosition);
 			ForcedRender.Add(ChunkPosition);
+			QueueRenderIfReady(ChunkPosition);
 		}
 		else
 		{
@@ -292,6 +306,7 @@ void UChunkTaskManager::ScheduleUnload(const TSet<FChunkPosition>& ChunksToUnloa
 			if (ProcessingRender.Contains(ChunkPosition))
 			{
 				ProcessingRender.Find(ChunkPosition)->LastRenderIndex = -1;
+				ProcessingRender.Find(ChunkPosition)->CancelToken.Cancel();
 			}
 		}
 		
@@ -304,13 +319,17 @@ void UChunkTaskManager::ScheduleUnload(const TSet<FChunkPosition>& ChunksToUnloa
 		{
 			UE_LOG(LogVirtualMapTaskManager, Verbose, TEXT("Cancelling load for chunk %s"), *ChunkPosition.ToString());
 			ProcessingLoad.Add(ChunkPosition, false);
+			LoadTokens.FindChecked(ChunkPosition).Cancel();
 		}
 
 		PendingRender.Remove(ChunkPosition);
+		ReadyRender.Remove(ChunkPosition);
+		Pipeline.Forget(ChunkPosition);
 		if (ProcessingRender.Contains(ChunkPosition))
 		{
 			UE_LOG(LogVirtualMapTaskManager, Verbose, TEXT("Cancelling render for chunk %s"), *ChunkPosition.ToString());
 			ProcessingRender.Find(ChunkPosition)->LastRenderIndex = -1;
+			ProcessingRender.Find(ChunkPosition)->CancelToken.Cancel();
 		}
 		
 		if (ProcessingUnload.Contains(ChunkPosition))
@@ -322,6 +341,26 @@ void UChunkTaskManager::ScheduleUnload(const TSet<FChunkPosition>& ChunksToUnloa
 
 		ProcessingUnload.Add(ChunkPosition, true);
 
+		auto FinishUnload = [ChunkPosition, this]
+		{
+			UE_LOG(LogVirtualMapTaskManager, Verbose, TEXT("Processing unload for chunk %s"), *ChunkPosition.ToString());
+
+			if (ProcessingUnload.FindRef(ChunkPosition) == true)
+			{
+				GameManager->ChunkRegistry->Th_UnregisterChunk(ChunkPosition);
+			}
+
+			ProcessingUnload.Remove(ChunkPosition);
+		};
+
+		// Chunks matching their region file, or already evicted, have nothing to save
+		const auto ChunkData = GameManager->ChunkRegistry->Th_GetChunkData(ChunkPosition);
+		if (!ChunkData || !ChunkData->IsDirty())
+		{
+			FinishUnload();
+			continue;
+		}
+
 		const auto RegionPosition = FRegionPosition::FromChunkPosition(ChunkPosition);
 		const auto LocalChunkPosition = FLocalChunkPosition::FromChunkPosition(ChunkPosition);
 		const auto Region = GameManager->ChunkRegistry->Th_GetRegionFile(RegionPosition);
@@ -332,30 +371,201 @@ void UChunkTaskManager::ScheduleUnload(const TSet<FChunkPosition>& ChunksToUnloa
 			continue;
 		}
 
-		const auto ChunkData = GameManager->ChunkRegistry->Th_GetChunkData(ChunkPosition);
-		GameManager->TickManager->RunAsyncThen(
-			[this, LocalChunkPosition, ChunkData, Region]
+		// Taken here so the save sees a consistent chunk, edits made meanwhile don't wait on it
+		FChunkSnapshot Snapshot = ChunkData->Th_GetSnapshot();
+		TArray<FEntityRecord> Entities = ChunkData->GetEntityRecords();
+
+		// Never cancelled, the chunk is gone from memory once it's unloaded
+		GameManager->TickManager->RunJobThen(EJobLane::Save, ETickCategory::ChunkSave, FJobCancellationToken(),
+			[LocalChunkPosition, Snapshot = MoveTemp(Snapshot), Entities = MoveTemp(Entities), Region]
 			{
-				if (!ChunkData)
-				{
-					UE_LOG(LogVirtualMapTaskManager, Warning, TEXT("Failed to unload chunk data at local position %s: chunk data not found."), *LocalChunkPosition.ToString());
-					return;
-				}
-				Region->Th_SaveChunk(LocalChunkPosition, ChunkData);
+				Region->Th_SaveChunk(LocalChunkPosition, Snapshot, Entities);
 			},
-			[ChunkPosition, this]
+			MoveTemp(FinishUnload)
+		);
+	}
+}
+
+bool UChunkTaskManager::IsChunkBusy(const FChunkPosition& Position) const
+{
+	if (ProcessingLoad.Contains(Position) || ProcessingUnload.Contains(Position) || ProcessingRender.Contains(Position)
+		|| PendingPacketsByPosition.Contains(Position))
+	{
+		return true;
+	}
+
+	for (const FPendingNetSendChunks& PendingPacket : PendingPackets)
+	{
+		if (PendingPacket.ToSend.Contains(Position))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UChunkTaskManager::QueueRenderIfReady(const FChunkPosition& Position)
+{
+	// Already queued or waiting, the one in flight queues it again once done
+	if (ReadyRender.Contains(Position) || Pipeline.IsWaiting(Position) || ProcessingRender.Contains(Position))
+	{
+		return;
+	}
+
+	if (WaitForRenderPrerequisites(Position))
+	{
+		Pipeline.Ready(Position);
+		ReadyRender.Add(Position);
+		bRenderQueueDirty = true;
+	}
+}
+
+bool UChunkTaskManager::WaitForRenderPrerequisites(const FChunkPosition& Position)
+{
+	static const std::array Offsets = {
+		FChunkPosition{0, 0},
+		FChunkPosition{0, 1},
+		FChunkPosition{0, -1},
+		FChunkPosition{1, 0},
+		FChunkPosition{-1, 0}
+	};
+
+	TArray<FChunkPosition, TInlineAllocator<5>> MissingData;
+	for (const auto& Offset : Offsets)
+	{
+		if (!GameManager->ChunkRegistry->Th_HasChunkData(Position + Offset))
+		{
+			MissingData.Add(Position + Offset);
+
+			// Dropped by the residency manager, bring it back for the render
+			FVirtualChunk* Neighbor = GameManager->VirtualMap->VirtualChunks.Find(Position + Offset);
+			if (Neighbor && Neighbor->bEvicted)
 			{
-				UE_LOG(LogVirtualMapTaskManager, Verbose, TEXT("Processing unload for chunk %s"), *ChunkPosition.ToString());
-				
-				if (ProcessingUnload.FindRef(ChunkPosition) == true)
-				{
-					GameManager->ChunkRegistry->Th_UnregisterChunk(ChunkPosition);	
-				}
+				Neighbor->bEvicted = false;
+				ScheduleLoad({ Position + Offset });
+			}
+		}
+	}
+
+	const bool bMissingActor = !GameManager->ChunkRegistry->GetChunkActor(Position);
+	if (MissingData.IsEmpty() && !bMissingActor)
+	{
+		return true;
+	}
+
+	Pipeline.Wait(Position, MissingData, bMissingActor);
+	return false;
+}
+
+void UChunkTaskManager::CompleteChunkData(const FChunkPosition& Position)
+{
+	TArray<FChunkPosition> Woken;
+	Pipeline.CompleteData(Position, Woken);
+	for (const FChunkPosition& Dependent : Woken)
+	{
+		if (PendingRender.Contains(Dependent))
+		{
+			QueueRenderIfReady(Dependent);
+		}
+	}
+}
+
+void UChunkTaskManager::ScheduleSpawn(const FChunkPosition& Position)
+{
+	const double RegisteredAt = FPlatformTime::Seconds();
 
-				ProcessingUnload.Remove(ChunkPosition);
+	// Prevent spawn from stuttering game
+	GameManager->TickManager->Th_ScheduleFn(ETickCategory::ChunkSpawn, [this, Position, RegisteredAt]
+	{
+		if (ProcessingUnload.Contains(Position) || !GameManager->ChunkRegistry->SpawnChunk(Position))
+		{
+			return;
+		}
+
+		Pipeline.Record(EChunkStage::Spawn, FPlatformTime::Seconds() - RegisteredAt);
+
+		TArray<FChunkPosition> Woken;
+		Pipeline.CompleteSpawn(Position, Woken);
+		for (const FChunkPosition& Dependent : Woken)
+		{
+			if (PendingRender.Contains(Dependent))
+			{
+				QueueRenderIfReady(Dependent);
 			}
-		);
+		}
+	});
+}
+
+void UChunkTaskManager::GetLocalPlayerViews(TArray<FRenderView>& OutViews) const
+{
+	for (FConstPlayerControllerIterator It = GameManager->GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* Controller = It->Get();
+		if (Controller && Controller->IsLocalController() && Controller->GetPawn())
+		{
+			FRenderView& View = OutViews.AddDefaulted_GetRef();
+			View.Position = FChunkPosition::FromActorLocation(Controller->GetPawn()->GetActorLocation());
+			View.Forward = FVector2D(Controller->GetControlRotation().Vector()).GetSafeNormal();
+		}
+	}
+}
+
+EJobLane UChunkTaskManager::GetLoadLane(const FChunkPosition& Position) const
+{
+	const int32 CriticalDistance = GameConstants::Jobs::CriticalDistance;
+	for (FConstPlayerControllerIterator It = GameManager->GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* Controller = It->Get();
+		if (!Controller || !Controller->GetPawn())
+		{
+			continue;
+		}
+
+		const FChunkPosition PlayerPosition = FChunkPosition::FromActorLocation(Controller->GetPawn()->GetActorLocation());
+		if (FMath::Abs(Position.X - PlayerPosition.X) <= CriticalDistance && FMath::Abs(Position.Y - PlayerPosition.Y) <= CriticalDistance)
+		{
+			return EJobLane::Critical;
+		}
+	}
+
+	return EJobLane::Prefetch;
+}
+
+float UChunkTaskManager::GetRenderPriority(const FChunkPosition& Position, const TArray<FRenderView>& Views)
+{
+	// Nobody looking, e.g. on a dedicated server, every chunk is as urgent
+	if (Views.IsEmpty())
+	{
+		return 0.0f;
+	}
+
+	const float ViewWeight = FMath::Max(GameConstants::Chunk::Render::ViewWeight, 0.0f);
+	float Priority = TNumericLimits<float>::Max();
+	for (const FRenderView& View : Views)
+	{
+		const FVector2D ToChunk(Position.X - View.Position.X, Position.Y - View.Position.Y);
+		const float Distance = ToChunk.Size();
+
+		// 1 straight ahead, -1 right behind
+		const float Facing = Distance > 0.0f && !View.Forward.IsZero() ? FVector2D::DotProduct(ToChunk / Distance, View.Forward) : 1.0f;
+		Priority = FMath::Min(Priority, Distance * (1.0f + ViewWeight * (1.0f - Facing) * 0.5f));
 	}
+
+	return Priority;
+}
+
+uint32 UChunkTaskManager::HashRenderViews(const TArray<FRenderView>& Views)
+{
+	uint32 Hash = GetTypeHash(Views.Num());
+	for (const FRenderView& View : Views)
+	{
+		// Eighths of a turn
+		const int32 Direction = View.Forward.IsZero() ? -1 : FMath::RoundToInt(FMath::Atan2(View.Forward.Y, View.Forward.X) / (UE_PI / 4));
+		Hash = HashCombineFast(Hash, HashCombineFast(GetTypeHash(View.Position), GetTypeHash(Direction)));
+	}
+
+	return Hash;
 }
 
 TStatId UChunkTaskManager::GetStatId() const
@@ -365,51 +575,81 @@ TStatId UChunkTaskManager::GetStatId() const
 
 void UChunkTaskManager::Tick(float DeltaTime)
 {
-	if (PendingRender.Num() != 0)
+	// Once a frame, outside of the game ticks: no raw pointer to the chunk data unloaded since the last one is left
+	GameManager->ChunkRegistry->FreeReleasedChunksData();
+
+	// Renders still missing something wait in the pipeline, they're added to ReadyRender the moment it shows up
+	if (ReadyRender.Num() != 0)
 	{
-		TArray<FChunkPosition> ToRemove;
-		for (const auto& ChunkPosition : PendingRender)
+		if (!MeshCache && GameConstants::Chunk::MeshCache::bEnabled && GameManager->WorldSave)
 		{
-			// Only start rendering when the chunk is loaded and spawned
-			const auto Chunk = GameManager->ChunkRegistry->GetChunkActor(ChunkPosition);
-			if (!Chunk)
+			MeshCache = MakeShared<FChunkMeshCache, ESPMode::ThreadSafe>(UWorldSave::GetMeshCacheDir(GameManager->WorldSave->WorldName));
+		}
+
+		TArray<FRenderView> Views;
+		GetLocalPlayerViews(Views);
+
+		TSet<FChunkPosition> PlayerChunks;
+		for (const FRenderView& View : Views)
+		{
+			PlayerChunks.Add(View.Position);
+		}
+
+		const uint32 ViewsHash = HashRenderViews(Views);
+		if (bRenderQueueDirty || ViewsHash != RenderQueueViewsHash)
+		{
+			TArray<TPair<float, FChunkPosition>> Prioritized;
+			Prioritized.Reserve(ReadyRender.Num());
+			for (const FChunkPosition& ChunkPosition : ReadyRender)
 			{
-				continue;
+				Prioritized.Emplace(GetRenderPriority(ChunkPosition, Views), ChunkPosition);
 			}
+			Prioritized.Sort([](const TPair<float, FChunkPosition>& A, const TPair<float, FChunkPosition>& B)
+			{
+				return A.Key < B.Key;
+			});
 
-			// Avoid double-scheduling renders for the same chunk
-			if (ProcessingRender.Contains(ChunkPosition))
+			RenderQueue.Reset(Prioritized.Num());
+			for (const TPair<float, FChunkPosition>& Entry : Prioritized)
 			{
-				continue;
+				RenderQueue.Add(Entry.Value);
 			}
+			bRenderQueueDirty = false;
+			RenderQueueViewsHash = ViewsHash;
+		}
+
+		// The rest waits for the next ticks, by then the closest ones are already on screen
+		const int32 MaxDispatch = GameConstants::Chunk::Render::MaxDispatchPerTick;
 
-			// Ensure this chunk and its 4 neighbors have data available to lock
-			bool bNeighborsReady = true;
-			static const std::array Offsets = {
-				FChunkPosition{0, 0},
-				FChunkPosition{0, 1},
-				FChunkPosition{0, -1},
-				FChunkPosition{1, 0},
-				FChunkPosition{-1, 0}
-			};
-			for (const auto& Offset : Offsets)
+		TArray<FChunkPosition> ToRemove;
+		for (const FChunkPosition& ChunkPosition : RenderQueue)
+		{
+			if (MaxDispatch > 0 && ToRemove.Num() >= MaxDispatch)
 			{
-				if (!GameManager->ChunkRegistry->Th_HasChunkData(ChunkPosition + Offset))
-				{
-					bNeighborsReady = false;
-					break;
-				}
+				break;
 			}
-			if (!bNeighborsReady)
+
+			// Unloaded since the queue was built
+			if (!ReadyRender.Contains(ChunkPosition))
 			{
 				continue;
 			}
 
+			// A neighbour evicted or unloaded since it became ready, back to waiting on it
+			if (!WaitForRenderPrerequisites(ChunkPosition))
+			{
+				ReadyRender.Remove(ChunkPosition);
+				continue;
+			}
+
+			const auto Chunk = GameManager->ChunkRegistry->GetChunkActor(ChunkPosition);
 			const auto State = GameManager->VirtualMap->VirtualChunks.FindRef(ChunkPosition).State;
 			Chunk->SetRenderState(State);
-			// If state = none = border, so we can't render it (as it will have no neighbors)
+			// If state = none = border, so we can't render it (as it will have no neighbors). Scheduled again when it changes
 			if (State == EChunkState::None)
 			{
+				PendingRender.Remove(ChunkPosition);
+				ReadyRender.Remove(ChunkPosition);
 				continue;
 			}
 
@@ -417,33 +657,81 @@ void UChunkTaskManager::Tick(float DeltaTime)
 			auto& ProcessingRef = ProcessingRender.FindOrAdd(ChunkPosition);
 			ProcessingRef.LastRenderIndex = RenderId;
 			ProcessingRef.PendingTasks++;
+			// Shared by every render of the chunk, only an unload cancels it and the renders after that need a new one
+			if (ProcessingRef.CancelToken.IsCancelled())
+			{
+				ProcessingRef.CancelToken = FJobCancellationToken();
+			}
+			const FJobCancellationToken Token = ProcessingRef.CancelToken;
+			// No local views, e.g. on a dedicated server, every priority is 0 and the players' pawns tell instead
+			const EJobLane Lane = Views.IsEmpty() ? GetLoadLane(ChunkPosition)
+				: GetRenderPriority(ChunkPosition, Views) <= GameConstants::Jobs::CriticalDistance ? EJobLane::Critical : EJobLane::Prefetch;
 			ToRemove.Add(ChunkPosition);
 
 			UE_LOG(LogVirtualMapTaskManager, Verbose, TEXT("Confirming schedule render for chunk %s with RenderId %d"), *ChunkPosition.ToString(), RenderId);
 
 			// Snapshot whether this render is forced to avoid cross-thread access to the set
 			const bool bForceForThis = ForcedRender.Contains(ChunkPosition);
+			const bool bPriority = PlayerChunks.Contains(ChunkPosition);
+			const int32 Lod = ChunkStateUtils::GetLod(State);
+			const EChunkMeshOutput Output = AChunk::GetMeshOutput(State);
 
-			GameManager->TickManager->RunAsyncThen(
-				[Chunk, this, ChunkPosition, bForceForThis]
+			TBitArray<> Sections;
+			FSectionQuadHints QuadHints;
+			Chunk->PrepareRender(RenderId, bForceForThis, Sections, QuadHints);
+
+			const TSharedPtr<FChunkMeshCache, ESPMode::ThreadSafe> CacheForThis =
+				MeshCache && FChunkMeshCache::IsCacheable(Sections, Output) ? MeshCache : nullptr;
+
+			GameManager->TickManager->RunJobThen(Lane, ETickCategory::ChunkRender, Token,
+				[WeakChunk = TWeakObjectPtr<AChunk>(Chunk), this, ChunkPosition, Output, Lod, bPriority, CacheForThis, Token, Sections = MoveTemp(Sections), QuadHints = MoveTemp(QuadHints)]
 				{
 					UE_LOG(LogVirtualMapTaskManager, VeryVerbose, TEXT("Starting render for chunk %s"), *ChunkPosition.ToString());
 					FRenderResult Result;
-					GameManager->ChunkRegistry->LockForRender(ChunkPosition);
-					Result.bSuccess = Chunk->BeginRender(Result.Mesh, bForceForThis);
-					GameManager->ChunkRegistry->UnlockForRender(ChunkPosition);
+					FRenderSnapshots Snapshots;
+					GameManager->ChunkRegistry->MarkForRender(ChunkPosition);
+					// Destroyed before the job started, or unloaded while the neighbours were snapshotted, meshing it would be thrown away
+					AChunk* Chunk = WeakChunk.Get();
+					if (Chunk && GameManager->ChunkRegistry->Th_GetRenderSnapshots(ChunkPosition, Snapshots) && !Token.IsCancelled())
+					{
+						const FRenderColumnWindow Window(Snapshots);
+						const uint64 CacheKey = CacheForThis ? FChunkMeshCache::MakeKey(ChunkPosition, Window, Output, Lod) : 0;
+						if (CacheForThis && CacheForThis->Th_Load(CacheKey, Result))
+						{
+							Result.bSuccess = true;
+						}
+						else
+						{
+							Result.bSuccess = Chunk->BeginRender(Result, Window, Sections, QuadHints, Output, Lod, bPriority);
+							if (CacheForThis && Result.bSuccess)
+							{
+								// Compressing and writing would hold the mesh back from its commit, nobody waits on them
+								FJobSystem::Get().Launch(EJobLane::Save, FJobCancellationToken(),
+									[CacheForThis, CacheKey, Entry = FChunkMeshCache::Th_Serialize(CacheKey, Result)](const bool bCancelled) mutable
+									{
+										CacheForThis->Th_Store(CacheKey, MoveTemp(Entry));
+									});
+							}
+						}
+					}
+					GameManager->ChunkRegistry->UnmarkForRender(ChunkPosition);
 					return MoveTemp(Result);
 				},
-				[Chunk, this, ChunkPosition, RenderId, bForceForThis](FRenderResult&& Result)
+				[WeakChunk = TWeakObjectPtr<AChunk>(Chunk), this, ChunkPosition, RenderId, bForceForThis, Token, DispatchedAt = FPlatformTime::Seconds()](FRenderResult&& Result)
 				{
 					UE_LOG(LogVirtualMapTaskManager, VeryVerbose, TEXT("Finishing render for chunk %s with RenderId %d"), *ChunkPosition.ToString(), RenderId);
+					Pipeline.Record(EChunkStage::Mesh, FPlatformTime::Seconds() - DispatchedAt);
 					const auto Processing = ProcessingRender.Find(ChunkPosition);
 					Processing->PendingTasks--;
 					// TODO analyze if Result.bSuccess may cause a mismatch? -> triggered one render, changed the RenderedAtChanges, but is not the last, so it's never committed
-					if (RenderId > Processing->LastCommitedRenderIndex && Result.bSuccess && Chunk)
+					// Unloaded after the mesh was built, or the actor destroyed with it
+					AChunk* Chunk = WeakChunk.Get();
+					if (RenderId > Processing->LastCommitedRenderIndex && Result.bSuccess && IsValid(Chunk) && !Token.IsCancelled())
 					{
 						UE_LOG(LogVirtualMapTaskManager, VeryVerbose, TEXT("Committing render for chunk %s with RenderId %d"), *ChunkPosition.ToString(), RenderId);
-						Chunk->CommitRender(MoveTemp(Result));
+						const double CommitStartedAt = FPlatformTime::Seconds();
+						Chunk->CommitRender(RenderId, MoveTemp(Result));
+						Pipeline.Record(EChunkStage::Commit, FPlatformTime::Seconds() - CommitStartedAt);
 						Processing->LastCommitedRenderIndex = RenderId;
 						if (bForceForThis)
 						{
@@ -455,6 +743,12 @@ void UChunkTaskManager::Tick(float DeltaTime)
 						UE_LOG(LogVirtualMapTaskManager, VeryVerbose, TEXT("All render tasks finished for chunk %s with RenderId %d"), *ChunkPosition.ToString(), RenderId);
 						OnAllRenderTasksFinishedForChunk.Broadcast(ChunkPosition);
 						ProcessingRender.Remove(ChunkPosition);
+
+						// Scheduled again while this one was in flight
+						if (PendingRender.Contains(ChunkPosition))
+						{
+							QueueRenderIfReady(ChunkPosition);
+						}
 					}
 				}
 			);
@@ -463,6 +757,11 @@ void UChunkTaskManager::Tick(float DeltaTime)
 		for (int32 i = 0; i < ToRemove.Num(); ++i)
 		{
 			PendingRender.Remove(ToRemove[i]);
+			ReadyRender.Remove(ToRemove[i]);
 		}
+		RenderQueue.RemoveAll([this](const FChunkPosition& ChunkPosition)
+		{
+			return !ReadyRender.Contains(ChunkPosition);
+		});
 	}
 }
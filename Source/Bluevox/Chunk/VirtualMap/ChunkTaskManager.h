@@ -3,18 +3,22 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "Bluevox/Chunk/Data/ChunkColumn.h"
+#include "Bluevox/Chunk/ChunkMeshStream.h"
+#include "Bluevox/Chunk/Data/ChunkColumnStorage.h"
 #include "Bluevox/Chunk/Position/ChunkPosition.h"
 #include "Bluevox/Entity/EntityTypes.h"
+#include "Bluevox/Tick/JobSystem.h"
+#include "ChunkPipeline.h"
 #include "DynamicMesh/DynamicMesh3.h"
 #include "UObject/Object.h"
 #include "ChunkTaskManager.generated.h"
 
 class UWorldSave;
+class FChunkMeshCache;
 class UTickManager;
 class AGameManager;
 class UChunkRegistry;
-class UChunkData;
+class FChunkData;
 class UVirtualMap;
 class AMainController;
 
@@ -27,8 +31,28 @@ struct FLoadResult
 	}
 
 	bool bSuccess = false;
-	TArray<FChunkColumn> Columns = {};
+	FChunkColumnStorage Columns;
 	TArray<FEntityRecord> Entities = {};
+
+	// Stage latencies, recorded once back on the game thread
+	double LoadSeconds = 0;
+	double GenerateSeconds = 0;
+	double FinishedAt = 0;
+};
+
+struct FRenderSection
+{
+	int32 Index = 0;
+
+	// Only the one matching the EChunkMeshOutput the section was emitted with is filled
+	UE::Geometry::FDynamicMesh3 Mesh;
+
+	FChunkMeshStream Stream;
+
+	// Translucent faces of a RawStream section, the dynamic mesh tells them apart by material ID instead
+	FChunkMeshStream TranslucentStream;
+
+	FChunkCollisionStream Collision;
 };
 
 struct FRenderResult
@@ -39,7 +63,19 @@ struct FRenderResult
 	
 	bool bSuccess = false;
 
-	UE::Geometry::FDynamicMesh3 Mesh;
+	EChunkMeshOutput Output = EChunkMeshOutput::RawStream;
+
+	// Only the sections that were re-emitted, the others keep their current mesh
+	TArray<FRenderSection> Sections;
+};
+
+// Where a local player stands and looks, renders are ordered from it
+struct FRenderView
+{
+	FChunkPosition Position;
+
+	// Horizontal camera direction, zero when unknown
+	FVector2D Forward = FVector2D::ZeroVector;
 };
 
 USTRUCT(BlueprintType)
@@ -55,6 +91,9 @@ struct FProcessingRender
 	
 	UPROPERTY()
 	int32 PendingTasks = 0;
+
+	// Cancelled when the chunk is unloaded, the render in flight stops at its next check
+	FJobCancellationToken CancelToken;
 };
 
 USTRUCT(BlueprintType)
@@ -85,10 +124,27 @@ class BLUEVOX_API UChunkTaskManager : public UObject, public FTickableGameObject
 	UPROPERTY()
 	TMap<FChunkPosition, bool> ProcessingLoad;
 
+	// Of the loads in ProcessingLoad, cancelled along with them so a load not started yet never runs
+	TMap<FChunkPosition, FJobCancellationToken> LoadTokens;
+
 	UPROPERTY()
 	TSet<FChunkPosition> PendingRender;
 
-	// Chunks in this set should bypass the usual dirty-check during mesh build
+	// Of PendingRender, the ones with the data of their chunk and neighbours and their actor there, the others wait
+	// in the pipeline until it wakes them
+	UPROPERTY()
+	TSet<FChunkPosition> ReadyRender;
+
+	// ReadyRender, most urgent first. Rebuilt when a render becomes ready or a local player moves or turns,
+	// chunks no longer ready are dropped from it as they are dispatched
+	TArray<FChunkPosition> RenderQueue;
+
+	bool bRenderQueueDirty = false;
+
+	// Local player views RenderQueue was ordered for
+	uint32 RenderQueueViewsHash = 0;
+
+	// Chunks in this set re-emit every mesh section, not only the dirty ones
 	UPROPERTY()
 	TSet<FChunkPosition> ForcedRender;
 
@@ -121,7 +177,37 @@ class BLUEVOX_API UChunkTaskManager : public UObject, public FTickableGameObject
 	UPROPERTY()
 	AGameManager* GameManager = nullptr;
 
+	// Created with the first render, once the world save knows where to put it. Shared with the render tasks
+	TSharedPtr<FChunkMeshCache, ESPMode::ThreadSafe> MeshCache;
+
+	FChunkPipeline Pipeline;
+
 	void Sv_ProcessPendingNetSend(const FPendingNetSendChunks& PendingNetSend) const;
+
+	// Adds the pending render of Position to ReadyRender if nothing it needs is missing, otherwise it waits on them
+	void QueueRenderIfReady(const FChunkPosition& Position);
+
+	// True if the data of Position and its 4 neighbours and its actor are there, otherwise the render waits on the
+	// missing ones in the pipeline
+	bool WaitForRenderPrerequisites(const FChunkPosition& Position);
+
+	// Wakes the renders waiting on the data of Position
+	void CompleteChunkData(const FChunkPosition& Position);
+
+	// Spawns the actor of the just registered chunk at Position on a later tick, then wakes its render
+	void ScheduleSpawn(const FChunkPosition& Position);
+
+	// Local players with a pawn, the chunks they stand in get every worker for their renders
+	void GetLocalPlayerViews(TArray<FRenderView>& OutViews) const;
+
+	// Critical close to any player, local or remote, so the server loads what each of them stands on first
+	EJobLane GetLoadLane(const FChunkPosition& Position) const;
+
+	// Lower is more urgent: the distance in chunks to the closest local player, stretched behind its camera
+	static float GetRenderPriority(const FChunkPosition& Position, const TArray<FRenderView>& Views);
+
+	// Only the chunks and the directions players look in, quantized, so standing still never reorders the queue
+	static uint32 HashRenderViews(const TArray<FRenderView>& Views);
 	
 public:
 	UPROPERTY(BlueprintAssignable)
@@ -147,6 +233,25 @@ public:
 	UFUNCTION()
 	void ScheduleUnload(const TSet<FChunkPosition>& ChunksToUnload);
 
+	// Being loaded, unloaded, rendered or waiting to be sent to a player
+	bool IsChunkBusy(const FChunkPosition& Position) const;
+
+	FChunkPipeline& GetPipeline()
+	{
+		return Pipeline;
+	}
+
+	const FChunkPipeline& GetPipeline() const
+	{
+		return Pipeline;
+	}
+
+	// nullptr while disabled or before the first render
+	const FChunkMeshCache* GetMeshCache() const
+	{
+		return MeshCache.Get();
+	}
+
 	virtual TStatId GetStatId() const override;
 
 	virtual void Tick(float DeltaTime) override;
@@ -27,6 +27,14 @@ struct FVirtualChunk
 	UPROPERTY()
 	bool bLiveLocal = false;
 
+	// Mesh detail by distance to the local player, only applies to chunks live for it
+	UPROPERTY()
+	uint8 Lod = 0;
+
+	// Still wanted but dropped from memory by UChunkResidencyManager, has to be loaded again before use
+	UPROPERTY()
+	bool bEvicted = false;
+
 	bool ShouldBeKeptAlive() const
 	{
 		return LiveForCount > 0 || LoadedForCount > 0;
@@ -36,7 +44,7 @@ struct FVirtualChunk
 	{
 		if (LiveForCount > 0)
 		{
-			State = bLiveLocal ? EChunkState::Live : EChunkState::RemoteLive;
+			State = bLiveLocal ? ChunkStateUtils::WithLod(EChunkState::Live, Lod) : EChunkState::RemoteLive;
 		} else if (LoadedForCount > 0)
 		{
 			State = EChunkState::LoadOnly;
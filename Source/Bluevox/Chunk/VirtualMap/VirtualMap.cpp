@@ -104,6 +104,13 @@ void UVirtualMap::AddPlayerToChunks(const AMainController* Controller,
 			auto& VirtualChunk = VirtualChunks[ChunkPosition];
 			VirtualChunk.LoadedForCount++;
 
+			// The new player is sent its data, it has to be in memory again
+			if (VirtualChunk.bEvicted)
+			{
+				VirtualChunk.bEvicted = false;
+				ScheduleLoad.Add(ChunkPosition);
+			}
+
 			UE_LOG(LogVirtualMap, VeryVerbose, TEXT("After add player %s to Load chunk %s: State: %s, LiveFor: %d, LoadedFor: %d"), *Controller->GetName(), *ChunkPosition.ToString(),
 				*UEnum::GetValueAsString(VirtualChunk.State), VirtualChunk.LiveForCount, VirtualChunk.LoadedForCount);
 		} else
@@ -139,6 +146,12 @@ void UVirtualMap::AddPlayerToChunks(const AMainController* Controller,
 			{
 				VirtualChunk.bLiveLocal = true;
 			}
+
+			if (VirtualChunk.bEvicted)
+			{
+				VirtualChunk.bEvicted = false;
+				ScheduleLoad.Add(ChunkPosition);
+			}
 			
 			VirtualChunk.RecalculateState();
 
@@ -173,6 +186,7 @@ void UVirtualMap::AddPlayerToChunks(const AMainController* Controller,
 
 void UVirtualMap::HandleStateUpdate(const AMainController* Controller, const TSet<FChunkPosition>& LoadToLive, const TSet<FChunkPosition>& LiveToLoad)
 {
+	TSet<FChunkPosition> ToReload;
 	const auto IsLocalPlayer = GameManager->LocalController == Controller;
 	for (const auto& Pos : LoadToLive)
 	{
@@ -185,6 +199,11 @@ void UVirtualMap::HandleStateUpdate(const AMainController* Controller, const TSe
 			{
 				VirtualChunk.bLiveLocal = true;
 			}
+			if (VirtualChunk.bEvicted)
+			{
+				VirtualChunk.bEvicted = false;
+				ToReload.Add(Pos);
+			}
 			VirtualChunk.RecalculateState();
 		} else
 		{
@@ -212,6 +231,7 @@ void UVirtualMap::HandleStateUpdate(const AMainController* Controller, const TSe
 		}
 	}
 
+	GameManager->ChunkTaskManager->ScheduleLoad(ToReload);
 	GameManager->ChunkTaskManager->ScheduleRender(LoadToLive.Union(LiveToLoad));
 }
 
@@ -247,6 +267,32 @@ void UVirtualMap::HandlePlayerMovement(const AMainController* Controller,
 	AddPlayerToChunks(Controller, AddedLoad, AddedLive);
 	RemovePlayerFromChunks(Controller, RemovedLoad, RemovedLive);
 	HandleStateUpdate(Controller, LoadToLive, LiveToLoad);
+
+	if (GameManager->LocalController == Controller)
+	{
+		UpdateLocalLods(NewPosition);
+	}
+}
+
+void UVirtualMap::UpdateLocalLods(const FChunkPosition& Center)
+{
+	TSet<FChunkPosition> ToRender;
+	for (auto& [Position, VirtualChunk] : VirtualChunks)
+	{
+		const uint8 Lod = UChunkHelper::GetLodForDistance(UChunkHelper::GetDistance(Center, Position));
+		if (VirtualChunk.Lod != Lod)
+		{
+			VirtualChunk.Lod = Lod;
+			VirtualChunk.RecalculateState();
+			if (VirtualChunk.bLiveLocal)
+			{
+				ToRender.Add(Position);
+			}
+		}
+	}
+
+	UE_LOG(LogVirtualMap, Verbose, TEXT("LOD changed for %d chunks around %s"), ToRender.Num(), *Center.ToString());
+	GameManager->ChunkTaskManager->ScheduleRender(ToRender);
 }
 
 UVirtualMap* UVirtualMap::Init(AGameManager* InGameManager)
@@ -279,6 +325,11 @@ void UVirtualMap::RegisterPlayer(AMainController* Player)
 	}
 	
 	AddPlayerToChunks(Player, LoadChunks, LiveChunks);
+
+	if (GameManager->LocalController == Player)
+	{
+		UpdateLocalLods(GlobalPosition);
+	}
 }
 
 void UVirtualMap::UnregisterPlayer(const AMainController* Player)
@@ -20,6 +20,7 @@ class BLUEVOX_API UVirtualMap : public UObject, public FTickableGameObject
 
 	friend class UChunkTaskManager;
 	friend class UChunkDataNetworkPacket;
+	friend class UChunkResidencyManager;
 
 	UPROPERTY()
 	TMap<const AMainController*, FChunkPosition> ChunkPositionByPlayer;
@@ -39,6 +40,9 @@ class BLUEVOX_API UVirtualMap : public UObject, public FTickableGameObject
 	UFUNCTION()
 	void HandlePlayerMovement(const AMainController* Controller, const FChunkPosition& OldPosition, const FChunkPosition& NewPosition);
 
+	// Re-levels the chunks live for the local player by their distance to Center, re-rendering the changed ones
+	void UpdateLocalLods(const FChunkPosition& Center);
+
 	UPROPERTY()
 	class AGameManager* GameManager = nullptr;
 
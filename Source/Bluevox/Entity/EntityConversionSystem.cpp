@@ -24,59 +24,51 @@ UEntityConversionSystem* UEntityConversionSystem::Init(AGameManager* InGameManag
 	return this;
 }
 
-void UEntityConversionSystem::GameTick(float DeltaTime)
+void UEntityConversionSystem::GetTickChunkAccess(TArray<FChunkPosition>& OutReads, TArray<FChunkPosition>& OutWrites)
 {
-	if (!GameManager || !GameManager->bServer) return;
+	if (!GameManager || !GameManager->bServer || !GameManager->ChunkRegistry) return;
 
-	AccumulatedSeconds += DeltaTime;
-	if (AccumulatedSeconds >= GameConstants::EntityConversion::IntervalSeconds)
-	{
-		AccumulatedSeconds = 0.0f;
-		EvaluateConversions();
-	}
-}
-
-void UEntityConversionSystem::EvaluateConversions()
-{
-	if (!GameManager || !GameManager->ChunkRegistry) return;
+	AccumulatedSeconds += GameManager->GetWorld()->GetDeltaSeconds();
+	if (AccumulatedSeconds < GameConstants::EntityConversion::IntervalSeconds) return;
+	AccumulatedSeconds = 0.0f;
 
 	// Gather player world locations on server
-	TArray<FVector> PlayerLocations;
+	ScanPlayerLocations.Reset();
 	for (FConstPlayerControllerIterator It = GameManager->GetWorld()->GetPlayerControllerIterator(); It; ++It)
 	{
 		APlayerController* PC = It->Get();
 		if (!PC) continue;
 		APawn* Pawn = PC->GetPawn();
 		if (!Pawn) continue;
-		PlayerLocations.Add(Pawn->GetActorLocation());
+		ScanPlayerLocations.Add(Pawn->GetActorLocation());
 	}
-	if (PlayerLocations.Num() == 0) return;
-
-	const float ToEntityCm = GameConstants::EntityConversion::ToEntityRangeCm;
-	const float ToInstanceCm = GameConstants::EntityConversion::ToInstanceRangeCm;
+	if (ScanPlayerLocations.Num() == 0) return;
 
 	// Get chunks that are potentially within conversion range
-	TArray<FChunkPosition> RelevantChunks = GetChunksWithinRange(PlayerLocations, ToInstanceCm);
+	TSet<FChunkPosition> ChunksToProcess(GetChunksWithinRange(ScanPlayerLocations, GameConstants::EntityConversion::ToInstanceRangeCm));
 
 	// Also include chunks that have converted entities (to check if they should be reverted)
-	TSet<FChunkPosition> ChunksToProcess;
-	for (const FChunkPosition& ChunkPos : RelevantChunks)
-	{
-		ChunksToProcess.Add(ChunkPos);
-	}
 	for (const auto& Pair : ConvertedEntities)
 	{
 		ChunksToProcess.Add(Pair.Key.ChunkPosition);
 	}
 
-	// Track which converted entities should remain converted
-	TSet<FConvertedEntityKey> EntitiesThatShouldBeConverted;
+	ScanChunks = ChunksToProcess.Array();
+	OutReads.Append(ScanChunks);
+	bScanning = true;
+}
+
+void UEntityConversionSystem::ParallelGameTick(float DeltaTime)
+{
+	if (!bScanning) return;
+
+	const float ToEntityCm = GameConstants::EntityConversion::ToEntityRangeCm;
 
-	// Process each relevant chunk
-	for (const FChunkPosition& ChunkPos : ChunksToProcess)
+	for (const FChunkPosition& ChunkPos : ScanChunks)
 	{
-		AChunk* Chunk = GameManager->ChunkRegistry->GetChunkActor(ChunkPos);
-		if (!Chunk || !Chunk->ChunkData) continue;
+		// The chunk data rather than the actor, the actors are only looked up on the game thread
+		FChunkData* ChunkData = GameManager->ChunkRegistry->Th_GetChunkData(ChunkPos);
+		if (!ChunkData) continue;
 
 		// Compute chunk bounds in world space
 		const float XYSize = GameConstants::Scaling::XYWorldSize;
@@ -86,13 +78,13 @@ void UEntityConversionSystem::EvaluateConversions()
 		                       0.0f);
 
 		// Check entities in this chunk
-		TArray<int32> EntitiesToConvert;
+		TArray<int32> ChunkEntitiesToConvert;
 
 		{
-			FReadScopeLock ReadLock(Chunk->ChunkData->Lock);
+			FReadScopeLock ReadLock(ChunkData->Lock);
 
 			// Iterate through all entities in the chunk
-			for (auto It = Chunk->ChunkData->Entities.CreateConstIterator(); It; ++It)
+			for (auto It = ChunkData->Entities.CreateConstIterator(); It; ++It)
 			{
 				const int32 EntityArrayIndex = It.GetIndex();
 				const FEntityRecord& Entity = *It;
@@ -102,7 +94,7 @@ void UEntityConversionSystem::EvaluateConversions()
 
 				// Find closest player distance
 				float MinDistToPlayer = TNumericLimits<float>::Max();
-				for (const FVector& PlayerLoc : PlayerLocations)
+				for (const FVector& PlayerLoc : ScanPlayerLocations)
 				{
 					float Dist = FVector::Dist(EntityWorldPos, PlayerLoc);
 					MinDistToPlayer = FMath::Min(MinDistToPlayer, Dist);
@@ -117,25 +109,39 @@ void UEntityConversionSystem::EvaluateConversions()
 					// Should be converted to entity
 					if (!bIsCurrentlyConverted)
 					{
-						EntitiesToConvert.Add(EntityArrayIndex);
+						ChunkEntitiesToConvert.Add(EntityArrayIndex);
 					}
 					EntitiesThatShouldBeConverted.Add(Key);
 				}
-				else if (MinDistToPlayer >= ToInstanceCm && bIsCurrentlyConverted)
+				else if (MinDistToPlayer >= GameConstants::EntityConversion::ToInstanceRangeCm && bIsCurrentlyConverted)
 				{
 					// Beyond reconversion distance and currently converted - will be reverted
-					// (handled later by comparing sets)
+					// (handled by the merge comparing sets)
 				}
 				// else: In hysteresis zone - maintain current state
 			}
 		}
 
-		// Convert entities to facades if needed
-		if (EntitiesToConvert.Num() > 0)
+		if (ChunkEntitiesToConvert.Num() > 0)
 		{
-			ConvertEntitiesToFacades(Chunk, EntitiesToConvert);
+			EntitiesToConvert.Emplace(ChunkPos, MoveTemp(ChunkEntitiesToConvert));
 		}
 	}
+}
+
+void UEntityConversionSystem::MergeGameTick()
+{
+	if (!bScanning) return;
+	bScanning = false;
+
+	// Convert entities to facades if needed
+	for (const TPair<FChunkPosition, TArray<int32>>& Pair : EntitiesToConvert)
+	{
+		AChunk* Chunk = GameManager->ChunkRegistry->GetChunkActor(Pair.Key);
+		if (!Chunk || !Chunk->ChunkData) continue;
+
+		ConvertEntitiesToFacades(Chunk, Pair.Value);
+	}
 
 	// Find entities that should be converted back to instances
 	TArray<FConvertedEntityKey> KeysToRevert;
@@ -152,6 +158,11 @@ void UEntityConversionSystem::EvaluateConversions()
 	{
 		ConvertFacadesToInstances(KeysToRevert);
 	}
+
+	ScanPlayerLocations.Reset();
+	ScanChunks.Reset();
+	EntitiesToConvert.Reset();
+	EntitiesThatShouldBeConverted.Reset();
 }
 
 TArray<FChunkPosition> UEntityConversionSystem::GetChunksWithinRange(const TArray<FVector>& PlayerLocations, float RangeCm) const
@@ -357,6 +368,9 @@ void UEntityConversionSystem::ConvertFacadesToInstances(const TArray<FConvertedE
 					Entity.Transform.AddToTranslation(-ChunkWorldOffset); // Convert back to local
 					Entity.bIsConvertedToEntity = false;
 
+					// The record moved, the chunk no longer matches its region file
+					Chunk->ChunkData->Changes++;
+
 					// Restore the instance visibility
 					if (Entity.InstanceIndex != INDEX_NONE)
 					{
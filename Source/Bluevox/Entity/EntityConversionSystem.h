@@ -48,7 +48,22 @@ public:
 	UEntityConversionSystem* Init(AGameManager* InGameManager);
 
 	// IGameTickable
-	virtual void GameTick(float DeltaTime) override;
+	virtual ETickCategory GetTickCategory() const override
+	{
+		return ETickCategory::Entity;
+	}
+
+	// The distances are measured on a worker, the facades are spawned and destroyed in the merge
+	virtual bool IsParallelTickSafe() const override
+	{
+		return true;
+	}
+
+	virtual void GetTickChunkAccess(TArray<FChunkPosition>& OutReads, TArray<FChunkPosition>& OutWrites) override;
+
+	virtual void ParallelGameTick(float DeltaTime) override;
+
+	virtual void MergeGameTick() override;
 
 private:
 	UPROPERTY()
@@ -60,7 +75,19 @@ private:
 
 	float AccumulatedSeconds = 0.0f;
 
-	void EvaluateConversions();
+	// Set by GetTickChunkAccess when the interval is up, the scan of this tick and its merge run then
+	bool bScanning = false;
+
+	// Taken on the game thread for the scan
+	TArray<FVector> ScanPlayerLocations;
+
+	// Chunks in range of a player or with converted entities, the reads declared for the scan
+	TArray<FChunkPosition> ScanChunks;
+
+	// Results of the scan, applied by the merge
+	TArray<TPair<FChunkPosition, TArray<int32>>> EntitiesToConvert;
+
+	TSet<FConvertedEntityKey> EntitiesThatShouldBeConverted;
 
 	// Helper to get chunks within range of player positions
 	TArray<FChunkPosition> GetChunksWithinRange(const TArray<FVector>& PlayerLocations, float RangeCm) const;
@@ -47,7 +47,7 @@ void AEntityFacade::PostNetInit()
 		if (Chunk && EntityIndex != INDEX_NONE)
 		{
 			// Get the entity record to find the instance index
-			UChunkData* ChunkData = Chunk->ChunkData;
+			FChunkData* ChunkData = Chunk->ChunkData;
 			if (ChunkData)
 			{
 				FReadScopeLock ReadLock(ChunkData->Lock);
@@ -75,7 +75,7 @@ void AEntityFacade::EndPlay(const EEndPlayReason::Type EndPlayReason)
 		if (Chunk)
 		{
 			// Get the entity record to find the instance transform and index
-			UChunkData* ChunkData = Chunk->ChunkData;
+			FChunkData* ChunkData = Chunk->ChunkData;
 			if (ChunkData)
 			{
 				FReadScopeLock ReadLock(ChunkData->Lock);
@@ -14,8 +14,106 @@ namespace GameConstants::Chunk
 }
 
 namespace GameConstants::Chunk::File
+{
+	// 2: pieces packed against a per-chunk material palette
+	extern inline constexpr int32 FileVersion = 2;
+}
+
+namespace GameConstants::Chunk::Render
+{
+	extern inline int32 SectionSize = 8;
+	static FAutoConsoleVariableRef CVarSectionSize(
+		TEXT("game.chunk.render.section_size"), SectionSize,
+		TEXT("Columns per side of a chunk mesh section, only dirty sections are re-emitted and re-uploaded"), ECVF_ReadOnly);
+
+	extern inline bool bRawMeshStreams = true;
+	static FAutoConsoleVariableRef CVarRawMeshStreams(
+		TEXT("game.chunk.render.raw_streams"), bRawMeshStreams,
+		TEXT("Emit chunk meshes as raw vertex streams into procedural mesh sections instead of building FDynamicMesh3"), ECVF_ReadOnly);
+
+	extern inline bool bGreedyMeshing = true;
+	static FAutoConsoleVariableRef CVarGreedyMeshing(
+		TEXT("game.chunk.render.greedy"), bGreedyMeshing,
+		TEXT("Merge coplanar caps and side spans of the same material across the columns of a section"), ECVF_Default);
+
+	extern inline int32 MaxDispatchPerTick = 16;
+	static FAutoConsoleVariableRef CVarMaxDispatchPerTick(
+		TEXT("game.chunk.render.max_dispatch_per_tick"), MaxDispatchPerTick,
+		TEXT("Chunk renders started per tick, closest to the local players first, 0 starts all of them at once"), ECVF_Default);
+
+	extern inline float ViewWeight = 1.0f;
+	static FAutoConsoleVariableRef CVarViewWeight(
+		TEXT("game.chunk.render.view_weight"), ViewWeight,
+		TEXT("How much farther a chunk behind the camera counts when ordering renders, 1 makes it count twice as far as one ahead"), ECVF_Default);
+
+	extern inline int32 BufferPoolSize = 32;
+	static FAutoConsoleVariableRef CVarBufferPoolSize(
+		TEXT("game.chunk.render.buffer_pool_size"), BufferPoolSize,
+		TEXT("Committed mesh buffers kept for reuse by the game thread and by each render worker, 0 frees them all"), ECVF_Default);
+
+	extern inline int32 WaterViewDepth = 8;
+	static FAutoConsoleVariableRef CVarWaterViewDepth(
+		TEXT("game.chunk.render.water_view_depth"), WaterViewDepth,
+		TEXT("Layers below the top of a water body opaque faces behind it are still meshed, deeper ones are culled"), ECVF_Default);
+}
+
+namespace GameConstants::Chunk::MeshCache
 {
 	extern inline constexpr int32 FileVersion = 1;
+
+	extern inline bool bEnabled = true;
+	static FAutoConsoleVariableRef CVarMeshCacheEnabled(
+		TEXT("game.chunk.mesh_cache.enabled"), bEnabled,
+		TEXT("Keep chunk meshes on disk, keyed by the columns they were built from, and reuse them instead of meshing again"), ECVF_ReadOnly);
+
+	extern inline int32 BudgetMB = 256;
+	static FAutoConsoleVariableRef CVarMeshCacheBudget(
+		TEXT("game.chunk.mesh_cache.budget_mb"), BudgetMB,
+		TEXT("Disk space of the chunk mesh cache, least recently used meshes are dropped past it"), ECVF_Default);
+}
+
+namespace GameConstants::Chunk::Lod
+{
+	extern inline int32 StartDistance = 8;
+	static FAutoConsoleVariableRef CVarLodStartDistance(
+		TEXT("game.chunk.lod.start_distance"), StartDistance,
+		TEXT("Chunks this far from the local player are meshed at LOD 1, each next LOD starts twice as far, 0 disables LODs"), ECVF_Default);
+}
+
+namespace GameConstants::Chunk::Residency
+{
+	extern inline int32 BudgetMB = 16384;
+	static FAutoConsoleVariableRef CVarResidencyBudget(
+		TEXT("game.chunk.residency.budget_mb"), BudgetMB,
+		TEXT("Memory the server keeps chunks resident within (columns, entities and meshes), 0 disables eviction"), ECVF_Default);
+
+	extern inline float IntervalSeconds = 1.0f;
+	static FAutoConsoleVariableRef CVarResidencyInterval(
+		TEXT("game.chunk.residency.interval_s"), IntervalSeconds,
+		TEXT("Interval in seconds between chunk memory scans"), ECVF_Default);
+
+	extern inline float MinIdleSeconds = 30.0f;
+	static FAutoConsoleVariableRef CVarResidencyMinIdle(
+		TEXT("game.chunk.residency.min_idle_s"), MinIdleSeconds,
+		TEXT("Load only chunks used or edited more recently than this are never evicted"), ECVF_Default);
+
+	extern inline int32 MaxEvictionsPerScan = 64;
+	static FAutoConsoleVariableRef CVarResidencyMaxEvictions(
+		TEXT("game.chunk.residency.max_evictions_per_scan"), MaxEvictionsPerScan,
+		TEXT("Upper bound of chunks evicted by a single scan, spreads the saves over several frames"), ECVF_Default);
+}
+
+namespace GameConstants::Chunk::Dedup
+{
+	extern inline bool bEnabled = true;
+	static FAutoConsoleVariableRef CVarDedupEnabled(
+		TEXT("game.chunk.dedup.enabled"), bEnabled,
+		TEXT("Share identical columns between chunks when they are loaded or generated"), ECVF_Default);
+
+	extern inline int32 MaxPiecesToShare = 8;
+	static FAutoConsoleVariableRef CVarDedupMaxPieces(
+		TEXT("game.chunk.dedup.max_pieces"), MaxPiecesToShare,
+		TEXT("Columns with more pieces than this are kept local, fragmented columns are rarely duplicated"), ECVF_Default);
 }
 
 namespace GameConstants::Scaling
@@ -67,6 +165,29 @@ namespace GameConstants::Region::File
 		TEXT("The size of a region file segment in bytes"), ECVF_Default);
 }
 
+namespace GameConstants::Jobs
+{
+	extern inline int32 CriticalWorkers = 0;
+	static FAutoConsoleVariableRef CVarCriticalWorkers(
+		TEXT("game.jobs.critical_workers"), CriticalWorkers,
+		TEXT("Workers busy at once with loads and meshes close to the players, 0 uses every task graph worker but one"), ECVF_Default);
+
+	extern inline int32 PrefetchWorkers = 2;
+	static FAutoConsoleVariableRef CVarPrefetchWorkers(
+		TEXT("game.jobs.prefetch_workers"), PrefetchWorkers,
+		TEXT("Workers busy at once with loads and meshes further away"), ECVF_Default);
+
+	extern inline int32 SaveWorkers = 1;
+	static FAutoConsoleVariableRef CVarSaveWorkers(
+		TEXT("game.jobs.save_workers"), SaveWorkers,
+		TEXT("Workers busy at once writing chunks to their region files"), ECVF_Default);
+
+	extern inline int32 CriticalDistance = 4;
+	static FAutoConsoleVariableRef CVarCriticalDistance(
+		TEXT("game.jobs.critical_distance"), CriticalDistance,
+		TEXT("Chunks up to this far from a player are loaded and meshed in the critical lane, the others are prefetched"), ECVF_Default);
+}
+
 namespace GameConstants::Tick
 {
 	extern inline int32 TicksPerSecond = 24;
@@ -78,6 +199,56 @@ namespace GameConstants::Tick
 	static FAutoConsoleVariableRef CVarTickBudget(
 		TEXT("game.ticks.budget_ns"), TickBudget,
 		TEXT("Maximum time (in nanoseconds) before spreading tasks across frames"), ECVF_Default);
+
+	extern inline bool bParallelGameTick = true;
+	static FAutoConsoleVariableRef CVarParallelGameTick(
+		TEXT("game.ticks.parallel"), bParallelGameTick,
+		TEXT("Tick the tickables declared thread safe on the workers, off ticks them in the same waves on the game thread"), ECVF_Default);
+
+	extern inline int32 ContinuationCapacity = 512;
+	static FAutoConsoleVariableRef CVarContinuationCapacity(
+		TEXT("game.ticks.continuation_capacity"), ContinuationCapacity,
+		TEXT("Async completions of each tick category waiting for the game thread kept without allocating, more fall back to a slower queue"), ECVF_ReadOnly);
+}
+
+// Fractions of game.ticks.budget_ns each category is sure to get when it has work, what's left of the budget once
+// they all had theirs goes to whoever still has work
+namespace GameConstants::Tick::Share
+{
+	extern inline float Default = 0.1f;
+	static FAutoConsoleVariableRef CVarShareDefault(
+		TEXT("game.ticks.share.default"), Default,
+		TEXT("Tick budget share of the tickables and continuations without a category"), ECVF_Default);
+
+	extern inline float ChunkLoad = 0.15f;
+	static FAutoConsoleVariableRef CVarShareChunkLoad(
+		TEXT("game.ticks.share.chunk_load"), ChunkLoad,
+		TEXT("Tick budget share of registering loaded chunks"), ECVF_Default);
+
+	extern inline float ChunkSpawn = 0.15f;
+	static FAutoConsoleVariableRef CVarShareChunkSpawn(
+		TEXT("game.ticks.share.chunk_spawn"), ChunkSpawn,
+		TEXT("Tick budget share of spawning chunk actors"), ECVF_Default);
+
+	extern inline float ChunkRender = 0.25f;
+	static FAutoConsoleVariableRef CVarShareChunkRender(
+		TEXT("game.ticks.share.chunk_render"), ChunkRender,
+		TEXT("Tick budget share of committing chunk meshes"), ECVF_Default);
+
+	extern inline float ChunkSave = 0.05f;
+	static FAutoConsoleVariableRef CVarShareChunkSave(
+		TEXT("game.ticks.share.chunk_save"), ChunkSave,
+		TEXT("Tick budget share of finishing chunk saves"), ECVF_Default);
+
+	extern inline float ChunkResidency = 0.1f;
+	static FAutoConsoleVariableRef CVarShareChunkResidency(
+		TEXT("game.ticks.share.chunk_residency"), ChunkResidency,
+		TEXT("Tick budget share of the chunk memory scans"), ECVF_Default);
+
+	extern inline float Entity = 0.2f;
+	static FAutoConsoleVariableRef CVarShareEntity(
+		TEXT("game.ticks.share.entity"), Entity,
+		TEXT("Tick budget share of the entity systems, conversions between instances and actors included"), ECVF_Default);
 }
 
 
@@ -7,6 +7,7 @@
 #include "MainController.h"
 #include "WorldSave.h"
 #include "Bluevox/Chunk/ChunkRegistry.h"
+#include "Bluevox/Chunk/ChunkResidencyManager.h"
 #include "Bluevox/Chunk/VirtualMap/ChunkTaskManager.h"
 #include "Bluevox/Chunk/VirtualMap/VirtualMap.h"
 #include "Bluevox/Tick/TickManager.h"
@@ -53,6 +54,7 @@ void AGameManager::BeginPlay()
 	if (bServer)
 	{
 		EntityConversionSystem = NewObject<UEntityConversionSystem>(this, TEXT("EntityConversionSystem"))->Init(this);
+		ChunkResidencyManager = NewObject<UChunkResidencyManager>(this, TEXT("ChunkResidencyManager"))->Init(this);
 	}
 	
 	const auto Controller = UGameplayStatics::GetPlayerController(GetWorld(), 0);
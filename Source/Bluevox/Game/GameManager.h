@@ -91,6 +91,10 @@ public:
 	UPROPERTY(EditAnywhere, Category = "Game")
 	UTickManager* TickManager = nullptr;
 
+	// Keeps resident chunks under the memory budget (server-only)
+	UPROPERTY(EditAnywhere, Category = "Game")
+	class UChunkResidencyManager* ChunkResidencyManager = nullptr;
+
 	// Entity/Instance conversion system (server-only)
 	UPROPERTY(EditAnywhere, Category = "Game")
 	class UEntityConversionSystem* EntityConversionSystem = nullptr;
@@ -14,3 +14,18 @@ enum class EMaterial : uint8
 	Snow UMETA(DisplayName = "Snow"),
 	Water UMETA(DisplayName = "Water"),
 };
+
+namespace MaterialUtils
+{
+	// Pieces coming from the network may carry anything, only these fit the palette of a chunk
+	inline bool IsValid(const EMaterial MaterialId)
+	{
+		return MaterialId <= EMaterial::Water;
+	}
+
+	// Meshed apart with the translucent chunk material, opaque faces right behind it stay visible
+	inline bool IsTranslucent(const EMaterial MaterialId)
+	{
+		return MaterialId == EMaterial::Water;
+	}
+}
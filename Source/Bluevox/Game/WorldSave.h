@@ -51,6 +51,11 @@ public:
 		return GetSaveDir(WorldName) / "Regions";
 	}
 	
+	static FString GetMeshCacheDir(const FString& WorldName)
+	{
+		return GetSaveDir(WorldName) / "MeshCache";
+	}
+
 	static FString GetNetworksDir(const FString& WorldName) 
 	{
 		return GetSaveDir(WorldName) / "Networks";
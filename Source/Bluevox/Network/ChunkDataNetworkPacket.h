@@ -4,12 +4,12 @@
 
 #include "CoreMinimal.h"
 #include "ClientNetworkPacket.h"
-#include "Bluevox/Chunk/Data/ChunkColumn.h"
+#include "Bluevox/Chunk/Data/ChunkColumnStorage.h"
 #include "Bluevox/Chunk/Position/ChunkPosition.h"
 #include "Bluevox/Entity/EntityTypes.h"
 #include "ChunkDataNetworkPacket.generated.h"
 
-class UChunkData;
+class FChunkData;
 
 USTRUCT()
 struct FChunkDataWithPosition
@@ -18,7 +18,8 @@ struct FChunkDataWithPosition
 
 	FChunkDataWithPosition() {}
 
-	FChunkDataWithPosition(const FChunkPosition& InPosition, const TArray<FChunkColumn>& InColumns,
+	FChunkDataWithPosition(const FChunkPosition& InPosition,
+		const TSharedPtr<const FChunkColumnStorage, ESPMode::ThreadSafe>& InColumns,
 		const TArray<FEntityRecord>& InEntities)
 		: Position(InPosition), Columns(InColumns), Entities(InEntities)
 	{
@@ -27,8 +28,9 @@ struct FChunkDataWithPosition
 	UPROPERTY()
 	FChunkPosition Position;
 
-	UPROPERTY()
-	TArray<FChunkColumn> Columns;
+	// Not reflected, only ever sent through the operator<< below.
+	// The server sends the chunk snapshot as is, no copy is made while the packet waits to be written.
+	TSharedPtr<const FChunkColumnStorage, ESPMode::ThreadSafe> Columns;
 
 	UPROPERTY()
 	TArray<FEntityRecord> Entities;
@@ -36,7 +38,18 @@ struct FChunkDataWithPosition
 	friend FArchive& operator<<(FArchive& Ar, FChunkDataWithPosition& Data)
 	{
 		Ar << Data.Position;
-		Ar << Data.Columns;
+		if (Ar.IsLoading())
+		{
+			const TSharedRef<FChunkColumnStorage, ESPMode::ThreadSafe> Received = MakeShared<FChunkColumnStorage, ESPMode::ThreadSafe>();
+			Received->Load(Ar);
+			// Last chance to write it, the storage is immutable once it becomes the chunk columns
+			Received->Intern();
+			Data.Columns = Received;
+		}
+		else
+		{
+			Data.Columns->Save(Ar);
+		}
 		Ar << Data.Entities;
 		return Ar;
 	}
@@ -0,0 +1,106 @@
+﻿#include "ContinuationQueue.h"
+
+FContinuationQueue::FContinuationQueue(const int32 InCapacity)
+{
+	Capacity = static_cast<int32>(FMath::RoundUpToPowerOfTwo(FMath::Max(InCapacity, 2)));
+	Mask = Capacity - 1;
+	Records = MakeUnique<FRecord[]>(Capacity);
+	for (int32 Index = 0; Index < Capacity; ++Index)
+	{
+		Records[Index].Sequence.store(Index, std::memory_order_relaxed);
+	}
+}
+
+FContinuationQueue::~FContinuationQueue()
+{
+	// Destroyed without running, whoever they'd call back is going away too
+	while (true)
+	{
+		FRecord& Record = Records[DequeuePos & Mask];
+		if (Record.Sequence.load(std::memory_order_acquire) != DequeuePos + 1)
+		{
+			break;
+		}
+
+		Record.Run(Record.Storage, false);
+		++DequeuePos;
+	}
+}
+
+bool FContinuationQueue::RunOne()
+{
+	// Taking turns, a ring that never empties doesn't starve what overflowed
+	bOverflowTurn = !bOverflowTurn;
+	if (bOverflowTurn && RunOverflow())
+	{
+		return true;
+	}
+
+	FRecord& Record = Records[DequeuePos & Mask];
+	if (Record.Sequence.load(std::memory_order_acquire) == DequeuePos + 1)
+	{
+		// Freed only once run, a callback scheduling another one never gets its own record
+		Record.Run(Record.Storage, true);
+		Record.Sequence.store(DequeuePos + Capacity, std::memory_order_release);
+		++DequeuePos;
+		return true;
+	}
+
+	return !bOverflowTurn && RunOverflow();
+}
+
+bool FContinuationQueue::IsEmpty() const
+{
+	const FRecord& Record = Records[DequeuePos & Mask];
+	return Record.Sequence.load(std::memory_order_acquire) != DequeuePos + 1 && Overflow.IsEmpty();
+}
+
+FContinuationQueue::FRecord* FContinuationQueue::Claim(uint64& OutTicket)
+{
+	uint64 Ticket = EnqueuePos.load(std::memory_order_relaxed);
+	while (true)
+	{
+		FRecord& Record = Records[Ticket & Mask];
+		const int64 Diff = static_cast<int64>(Record.Sequence.load(std::memory_order_acquire)) - static_cast<int64>(Ticket);
+		if (Diff == 0)
+		{
+			if (EnqueuePos.compare_exchange_weak(Ticket, Ticket + 1, std::memory_order_relaxed))
+			{
+				OutTicket = Ticket;
+				return &Record;
+			}
+		}
+		else if (Diff < 0)
+		{
+			// Not run yet since the last lap
+			return nullptr;
+		}
+		else
+		{
+			Ticket = EnqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+bool FContinuationQueue::RunOverflow()
+{
+	TUniqueFunction<void()> Func;
+	if (!Overflow.Dequeue(Func))
+	{
+		return false;
+	}
+
+	Func();
+	return true;
+}
+
+void FContinuationQueue::EnqueueOverflow(TUniqueFunction<void()>&& Func)
+{
+	if (NumOverflowed.fetch_add(1, std::memory_order_relaxed) == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Game thread continuation ring of %d records full, or a callback over %d bytes. It falls back to a queue that allocates"),
+			Capacity, RecordSize);
+	}
+
+	Overflow.Enqueue(MoveTemp(Func));
+}
@@ -0,0 +1,110 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+/**
+ * Callbacks from the workers to the game thread, many producers and one consumer. Each callback is moved into a fixed
+ * size record of a ring allocated up front, so a completion allocates neither a TFunction nor a queue node and its
+ * result is moved, never copied. Callbacks bigger than a record, or arriving while the ring is full, go to a regular
+ * queue instead: slower and in no particular order with the ring, but never lost.
+ */
+class BLUEVOX_API FContinuationQueue
+{
+public:
+	// Fits the load and render completions of the chunk task manager, results included
+	static constexpr int32 RecordSize = 384;
+
+	explicit FContinuationQueue(const int32 InCapacity);
+
+	~FContinuationQueue();
+
+	FContinuationQueue(const FContinuationQueue&) = delete;
+
+	FContinuationQueue& operator=(const FContinuationQueue&) = delete;
+
+	// Any thread
+	template<typename FuncType>
+	void Enqueue(FuncType&& Func);
+
+	// Game thread, runs the oldest callback of the ring or of the overflow, one after the other. False if there were none
+	bool RunOne();
+
+	bool IsEmpty() const;
+
+	int32 GetCapacity() const
+	{
+		return Capacity;
+	}
+
+	// Callbacks that didn't fit the ring since it was created
+	int32 GetNumOverflowed() const
+	{
+		return NumOverflowed.load(std::memory_order_relaxed);
+	}
+
+private:
+	struct FRecord
+	{
+		// Equal to the ticket of the producer when free, one above once published, Capacity above once run
+		std::atomic<uint64> Sequence;
+
+		// Runs the callable in Storage when bRun, then destroys it
+		void (*Run)(void* Storage, bool bRun) = nullptr;
+
+		alignas(16) uint8 Storage[RecordSize];
+	};
+
+	TUniquePtr<FRecord[]> Records;
+
+	int32 Capacity = 0;
+
+	uint64 Mask = 0;
+
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> EnqueuePos{0};
+
+	// Only read and written by the consumer
+	alignas(PLATFORM_CACHE_LINE_SIZE) uint64 DequeuePos = 0;
+
+	// Only read and written by the consumer, whether the overflow goes first on the next run
+	bool bOverflowTurn = false;
+
+	std::atomic<int32> NumOverflowed{0};
+
+	TQueue<TUniqueFunction<void()>, EQueueMode::Mpsc> Overflow;
+
+	// A free record for the producer and its ticket, nullptr when the ring is full
+	FRecord* Claim(uint64& OutTicket);
+
+	void EnqueueOverflow(TUniqueFunction<void()>&& Func);
+
+	// Consumer only, false if the overflow was empty
+	bool RunOverflow();
+};
+
+template<typename FuncType>
+void FContinuationQueue::Enqueue(FuncType&& Func)
+{
+	using FCallable = std::decay_t<FuncType>;
+	if constexpr (sizeof(FCallable) <= RecordSize && alignof(FCallable) <= 16)
+	{
+		uint64 Ticket;
+		if (FRecord* Record = Claim(Ticket))
+		{
+			new (Record->Storage) FCallable(Forward<FuncType>(Func));
+			Record->Run = [](void* Storage, const bool bRun)
+			{
+				FCallable& Callable = *static_cast<FCallable*>(Storage);
+				if (bRun)
+				{
+					Callable();
+				}
+				Callable.~FCallable();
+			};
+			Record->Sequence.store(Ticket + 1, std::memory_order_release);
+			return;
+		}
+	}
+
+	EnqueueOverflow(TUniqueFunction<void()>(Forward<FuncType>(Func)));
+}
@@ -3,6 +3,8 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "TickCost.h"
+#include "Bluevox/Chunk/Position/ChunkPosition.h"
 #include "UObject/Interface.h"
 #include "GameTickable.generated.h"
 
@@ -22,4 +24,37 @@ class BLUEVOX_API IGameTickable
 
 public:
 	virtual void GameTick(float DeltaTime);
+
+	// Read once, when the first tickable of the class is registered
+	virtual ETickCategory GetTickCategory() const
+	{
+		return ETickCategory::Default;
+	}
+
+	/**
+	 * Opts the class into the parallel game tick, read once like the category. Its tickables get ParallelGameTick on
+	 * a worker then MergeGameTick on the game thread instead of GameTick, once per game tick and all at its start.
+	 */
+	virtual bool IsParallelTickSafe() const
+	{
+		return false;
+	}
+
+	/**
+	 * Game thread, each game tick before the waves are split. The chunks ParallelGameTick reads and writes, it never
+	 * runs alongside one writing what it reads or writes. Also where it takes what it needs from the game.
+	 */
+	virtual void GetTickChunkAccess(TArray<FChunkPosition>& OutReads, TArray<FChunkPosition>& OutWrites)
+	{
+	}
+
+	// Any worker. Only touches the declared chunks and its own state, what the game has to see is kept for the merge
+	virtual void ParallelGameTick(float DeltaTime)
+	{
+	}
+
+	// Game thread, after the ParallelGameTick of its wave, in registration order
+	virtual void MergeGameTick()
+	{
+	}
 };
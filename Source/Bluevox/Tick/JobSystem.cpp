@@ -0,0 +1,101 @@
+﻿#include "JobSystem.h"
+
+#include "Bluevox/Game/GameConstants.h"
+#include "Tasks/Task.h"
+
+FJobSystem& FJobSystem::Get()
+{
+	static FJobSystem JobSystem;
+	return JobSystem;
+}
+
+void FJobSystem::Launch(const EJobLane Lane, const FJobCancellationToken& Token,
+	TUniqueFunction<void(bool bCancelled)>&& Job)
+{
+	FLane& LaneRef = Lanes[static_cast<uint8>(Lane)];
+	FScopeLock ScopeLock(&LaneRef.Lock);
+	LaneRef.Queue.EmplaceLast(FJob{Token, MoveTemp(Job)});
+	StartWorkers(Lane);
+}
+
+int32 FJobSystem::GetMaxWorkers(const EJobLane Lane)
+{
+	switch (Lane)
+	{
+	case EJobLane::Critical:
+		// Every worker but one, the game thread waits on the task graph for other things too
+		return GameConstants::Jobs::CriticalWorkers > 0
+			? GameConstants::Jobs::CriticalWorkers
+			: FMath::Max(FTaskGraphInterface::Get().GetNumWorkerThreads() - 1, 1);
+	case EJobLane::Prefetch:
+		return FMath::Max(GameConstants::Jobs::PrefetchWorkers, 1);
+	case EJobLane::Save:
+		return FMath::Max(GameConstants::Jobs::SaveWorkers, 1);
+	default:
+		return 1;
+	}
+}
+
+void FJobSystem::LogStats() const
+{
+	static const TCHAR* LaneNames[] = {TEXT("Critical"), TEXT("Prefetch"), TEXT("Save")};
+	for (uint8 Lane = 0; Lane < static_cast<uint8>(EJobLane::Num); ++Lane)
+	{
+		const FLane& LaneRef = Lanes[Lane];
+		FScopeLock ScopeLock(&LaneRef.Lock);
+		UE_LOG(LogTemp, Display, TEXT("%s jobs: %d queued, %d of %d workers busy, %d completed, %d cancelled"),
+			LaneNames[Lane], LaneRef.Queue.Num(), LaneRef.NumRunning, GetMaxWorkers(static_cast<EJobLane>(Lane)),
+			LaneRef.NumCompleted, LaneRef.NumCancelled);
+	}
+}
+
+void FJobSystem::StartWorkers(const EJobLane Lane)
+{
+	FLane& LaneRef = Lanes[static_cast<uint8>(Lane)];
+	const int32 MaxWorkers = GetMaxWorkers(Lane);
+	while (LaneRef.NumRunning < MaxWorkers && LaneRef.NumRunning < LaneRef.Queue.Num())
+	{
+		LaneRef.NumRunning++;
+
+		const UE::Tasks::ETaskPriority Priority = Lane == EJobLane::Critical ? UE::Tasks::ETaskPriority::High
+			: Lane == EJobLane::Prefetch ? UE::Tasks::ETaskPriority::Normal
+			: UE::Tasks::ETaskPriority::BackgroundNormal;
+		UE::Tasks::Launch(UE_SOURCE_LOCATION, [this, Lane]
+		{
+			RunWorker(Lane);
+		}, Priority);
+	}
+}
+
+void FJobSystem::RunWorker(const EJobLane Lane)
+{
+	FLane& LaneRef = Lanes[static_cast<uint8>(Lane)];
+	while (true)
+	{
+		FJob Job;
+		{
+			FScopeLock ScopeLock(&LaneRef.Lock);
+			if (LaneRef.Queue.IsEmpty())
+			{
+				LaneRef.NumRunning--;
+				return;
+			}
+			Job = MoveTemp(LaneRef.Queue.First());
+			LaneRef.Queue.PopFirst();
+		}
+
+		const bool bCancelled = Job.Token.IsCancelled();
+		Job.Run(bCancelled);
+
+		FScopeLock ScopeLock(&LaneRef.Lock);
+		(bCancelled ? LaneRef.NumCancelled : LaneRef.NumCompleted)++;
+	}
+}
+
+static FAutoConsoleCommand CmdJobStats(
+	TEXT("game.jobs.stats"),
+	TEXT("Logs the queued, running, completed and cancelled jobs of each voxel job lane"),
+	FConsoleCommandDelegate::CreateLambda([]
+	{
+		FJobSystem::Get().LogStats();
+	}));
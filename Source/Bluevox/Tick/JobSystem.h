@@ -0,0 +1,91 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+#include "Containers/Deque.h"
+
+enum class EJobLane : uint8
+{
+	// Loads and meshes of the chunks players stand in or are about to see
+	Critical,
+
+	// Loads and meshes further away, needed later if at all
+	Prefetch,
+
+	// Writes to disk nobody waits on
+	Save,
+
+	Num
+};
+
+/**
+ * Cancels a job from the game thread. Copies share the same state: the scheduler skips a job cancelled before it
+ * starts, and long jobs check it between their stages to stop early.
+ */
+class FJobCancellationToken
+{
+public:
+	void Cancel() const
+	{
+		bCancelled->store(true, std::memory_order_relaxed);
+	}
+
+	bool IsCancelled() const
+	{
+		return bCancelled->load(std::memory_order_relaxed);
+	}
+
+private:
+	TSharedRef<std::atomic<bool>, ESPMode::ThreadSafe> bCancelled = MakeShared<std::atomic<bool>, ESPMode::ThreadSafe>(false);
+};
+
+/**
+ * Voxel work (chunk loads, meshes and saves) split in lanes, each with its own FIFO queue, task priority and limit of
+ * workers busy at once, so a burst of prefetches or saves never holds back what the player is waiting for.
+ * Process wide, the lanes bound the workers of every world together.
+ */
+class BLUEVOX_API FJobSystem
+{
+public:
+	static FJobSystem& Get();
+
+	/**
+	 * Queues Job on Lane, it runs on a worker once fewer than the lane limit are busy.
+	 * Job is always called, with bCancelled set and expected to do nothing when the token was cancelled before it
+	 * started, so whoever waits on its completion still hears back.
+	 */
+	void Launch(const EJobLane Lane, const FJobCancellationToken& Token, TUniqueFunction<void(bool bCancelled)>&& Job);
+
+	static int32 GetMaxWorkers(const EJobLane Lane);
+
+	void LogStats() const;
+
+private:
+	struct FJob
+	{
+		FJobCancellationToken Token;
+
+		TUniqueFunction<void(bool bCancelled)> Run;
+	};
+
+	struct FLane
+	{
+		mutable FCriticalSection Lock;
+
+		TDeque<FJob> Queue;
+
+		int32 NumRunning = 0;
+
+		int32 NumCompleted = 0;
+
+		int32 NumCancelled = 0;
+	};
+
+	// Starts workers on the lane while it has jobs waiting and room for them. Needs the lane lock
+	void StartWorkers(const EJobLane Lane);
+
+	// Runs the jobs of the lane until its queue is empty
+	void RunWorker(const EJobLane Lane);
+
+	TStaticArray<FLane, static_cast<uint8>(EJobLane::Num)> Lanes;
+};
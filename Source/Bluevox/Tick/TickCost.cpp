@@ -0,0 +1,64 @@
+﻿#include "TickCost.h"
+
+#include "Bluevox/Game/GameConstants.h"
+
+const TCHAR* LexToString(const ETickCategory Category)
+{
+	switch (Category)
+	{
+	case ETickCategory::ChunkLoad:
+		return TEXT("ChunkLoad");
+	case ETickCategory::ChunkSpawn:
+		return TEXT("ChunkSpawn");
+	case ETickCategory::ChunkRender:
+		return TEXT("ChunkRender");
+	case ETickCategory::ChunkSave:
+		return TEXT("ChunkSave");
+	case ETickCategory::ChunkResidency:
+		return TEXT("ChunkResidency");
+	case ETickCategory::Entity:
+		return TEXT("Entity");
+	default:
+		return TEXT("Default");
+	}
+}
+
+float TickCategoryUtils::GetShare(const ETickCategory Category)
+{
+	switch (Category)
+	{
+	case ETickCategory::ChunkLoad:
+		return GameConstants::Tick::Share::ChunkLoad;
+	case ETickCategory::ChunkSpawn:
+		return GameConstants::Tick::Share::ChunkSpawn;
+	case ETickCategory::ChunkRender:
+		return GameConstants::Tick::Share::ChunkRender;
+	case ETickCategory::ChunkSave:
+		return GameConstants::Tick::Share::ChunkSave;
+	case ETickCategory::ChunkResidency:
+		return GameConstants::Tick::Share::ChunkResidency;
+	case ETickCategory::Entity:
+		return GameConstants::Tick::Share::Entity;
+	default:
+		return GameConstants::Tick::Share::Default;
+	}
+}
+
+void FTickCost::Add(const uint64 Cycles, const uint64 Frame, const uint64 ShareCycles)
+{
+	TLatencyHistogram::Add(FPlatformTime::ToSeconds64(Cycles) * 1'000'000.0);
+
+	if (Frame != LastFrame)
+	{
+		LastFrame = Frame;
+		LastFrameCycles = 0;
+	}
+
+	// Counted once, when the frame crosses the share
+	const bool bWasOver = LastFrameCycles > ShareCycles;
+	LastFrameCycles += Cycles;
+	if (!bWasOver && LastFrameCycles > ShareCycles)
+	{
+		OverBudgetFrames++;
+	}
+}
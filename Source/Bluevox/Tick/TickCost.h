@@ -0,0 +1,50 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Bluevox/Utils/LatencyHistogram.h"
+
+// What a tickable or a scheduled continuation belongs to, each gets its own share of the tick budget
+enum class ETickCategory : uint8
+{
+	Default,
+
+	// Chunk loads coming back from their job, registering the data
+	ChunkLoad,
+
+	// Spawning the actors of the chunks just registered
+	ChunkSpawn,
+
+	// Committing chunk meshes to their components
+	ChunkRender,
+
+	// Chunk saves coming back, unregistering the data
+	ChunkSave,
+
+	ChunkResidency,
+
+	Entity,
+
+	Num
+};
+
+BLUEVOX_API const TCHAR* LexToString(const ETickCategory Category);
+
+namespace TickCategoryUtils
+{
+	// Fraction of the tick budget the category is sure to get when it has work, see game.ticks.share.*
+	BLUEVOX_API float GetShare(const ETickCategory Category);
+}
+
+// Time spent by one tickable class or continuation category, in microseconds. The last bucket is 256 ms and above
+struct BLUEVOX_API FTickCost : TLatencyHistogram<20>
+{
+	// Frames this alone spent more than the share of its category
+	uint32 OverBudgetFrames = 0;
+
+	void Add(const uint64 Cycles, const uint64 Frame, const uint64 ShareCycles);
+
+private:
+	uint64 LastFrame = 0;
+
+	uint64 LastFrameCycles = 0;
+};
@@ -3,66 +3,92 @@
 
 #include "TickManager.h"
 
+#include "TickStats.h"
 #include "Bluevox/Game/GameConstants.h"
+#include "Bluevox/Game/GameManager.h"
+#include "Async/ParallelFor.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
 
-void UTickManager::RemoveTickableByIndexes(TArray<int32>& Indexes)
+bool UTickManager::CanSpend(const ETickCategory Category, const bool bLeftover) const
 {
-	if (Indexes.Num() == 0)
-	{
-		return;
-	}
-	
-	const auto Class = TickableClasses.IsValidIndex(CurrentTickableClassIndex) ? TickableClasses[CurrentTickableClassIndex] : nullptr;
-	CurrentTickableIndex -= FMath::Max(Indexes.Num(), 0);
-	
-	if (!TickablesByClass.Contains(Class))
-	{
-		UE_LOG(LogTemp, Warning, TEXT("[RemoveTickableByIndexes] Tickable class %s not found in TickablesByClass map."), *Class->GetName());
-		return;
-	}
-	
-	for (const int32 Index : Indexes)
-	{
-		TickablesByClass[Class].RemoveAt(Index);
-	}
+	return CurrentBudget > 0 && (bLeftover || CategorySpent[static_cast<uint8>(Category)] < GetShareCycles(Category));
+}
+
+void UTickManager::Spend(const ETickCategory Category, const int64 Cycles)
+{
+	CurrentBudget -= Cycles;
+	CategorySpent[static_cast<uint8>(Category)] += Cycles;
+}
 
-	if (TickablesByClass[Class].Num() == 0)
+int64 UTickManager::GetShareCycles(const ETickCategory Category) const
+{
+	return static_cast<int64>(CalculatedTickBudget * FMath::Clamp(TickCategoryUtils::GetShare(Category), 0.f, 1.f));
+}
+
+void UTickManager::RunScheduledFns(const bool bLeftover)
+{
+	bool bRanAny = true;
+	while (bRanAny)
 	{
-		TickablesByClass.Remove(Class);
-		TickableClasses.Remove(Class);
-		CurrentTickableClassIndex = TickableClasses.Num() > 0 ? CurrentTickableClassIndex - 1 : -1;
-	}
+		bRanAny = false;
+		for (uint8 Index = 0; Index < static_cast<uint8>(ETickCategory::Num); ++Index)
+		{
+			const ETickCategory Category = static_cast<ETickCategory>(Index);
+			if (!CanSpend(Category, bLeftover))
+			{
+				continue;
+			}
+
+			const uint64 StartTime = FPlatformTime::Cycles64();
+			bool bRan;
+			{
+				FScopeCycleCounter CycleCounter(ContinuationStatIds[Index]);
+				bRan = ScheduledFns[Index]->RunOne();
+			}
+			if (!bRan)
+			{
+				continue;
+			}
 
-	Indexes.Reset();
+			const uint64 Cycles = FPlatformTime::Cycles64() - StartTime;
+			Spend(Category, Cycles);
+			ContinuationCosts[Index].Add(Cycles, FrameNumber, GetShareCycles(Category));
+			bRanAny = true;
+		}
+	}
 }
 
 void UTickManager::Tick(float DeltaTime)
 {
 	CurrentBudget = CalculatedTickBudget;
-	
-	// Continue previous tickables processing
-	if (bRunningGameTick)
+	FrameNumber++;
+	for (int64& Spent : CategorySpent)
 	{
-		GameTick();
+		Spent = 0;
 	}
-	
-	while (!ScheduledFns.IsEmpty() && CurrentBudget > 0)
+
+	// Every category gets its share first, so a burst of one of them can't starve the others
+	if (bRunningGameTick)
 	{
-		TFunction<void()> Func;
-		if (ScheduledFns.Dequeue(Func))
-		{
-			const auto StartTime = FPlatformTime::Cycles();
-			Func();
-			const auto EndTime = FPlatformTime::Cycles();
-			CurrentBudget -= EndTime - StartTime;
-		}
+		GameTick(false);
 	}
+	RunScheduledFns(false);
 
-	if (FPlatformTime::Cycles() > LastGameTickTime + CalculatedCyclesNeededToTick && CurrentBudget > 0)
+	if (!bRunningGameTick && FPlatformTime::Cycles() > LastGameTickTime + CalculatedCyclesNeededToTick && CurrentBudget > 0)
 	{
 		PrepareForGameTick();
-		GameTick();
+		RunParallelGameTick();
+		GameTick(false);
 	}
+
+	// Then whatever is left of the budget, to whoever still has work
+	if (bRunningGameTick)
+	{
+		GameTick(true);
+	}
+	RunScheduledFns(true);
 }
 
 TStatId UTickManager::GetStatId() const
@@ -73,50 +99,186 @@ TStatId UTickManager::GetStatId() const
 void UTickManager::PrepareForGameTick()
 {
 	bRunningGameTick = true;
-	CurrentTickableIndex = 0;
-	CurrentTickableClassIndex = TickableClasses.Num() > 0 ? 0 : -1;
+	for (auto& [Class, Bucket] : TickablesByClass)
+	{
+		Bucket.NextIndex = 0;
+	}
 }
 
-void UTickManager::GameTick()
+void UTickManager::GameTick(const bool bLeftover)
 {
-	TArray<int32> ToRemoveIdx;
-	
-	ON_SCOPE_EXIT {
-		RemoveTickableByIndexes(ToRemoveIdx);
-	};
-	
 	const auto DeltaTime = GetWorld()->GetDeltaSeconds();
-	for (int i = CurrentTickableClassIndex; i < TickableClasses.Num() && i != -1; i++)
+	bool bDone = true;
+
+	// By index and looked up again after each tick, a tickable may register or unregister others
+	for (int32 ClassIndex = 0; ClassIndex < TickableClasses.Num(); ++ClassIndex)
 	{
-		const auto CurrentTickableClass = TickableClasses[i];
-		const auto CurrentTickableList = TickablesByClass.FindRef(CurrentTickableClass);
-		const auto Len = CurrentTickableList.Num();
+		const UClass* Class = TickableClasses[ClassIndex];
+		while (true)
+		{
+			FTickableBucket* Bucket = TickablesByClass.Find(Class);
+			if (!Bucket || Bucket->bParallel || Bucket->NextIndex >= Bucket->Tickables.Num())
+			{
+				break;
+			}
 
-		for (int j = CurrentTickableIndex; j < Len; ++j)
+			const ETickCategory Category = Bucket->Category;
+			if (!CanSpend(Category, bLeftover))
+			{
+				bDone = false;
+				break;
+			}
+
+			const TScriptInterface<IGameTickable> Tickable = Bucket->Tickables[Bucket->NextIndex];
+			if (!Tickable)
+			{
+				Bucket->Tickables.RemoveAt(Bucket->NextIndex);
+				continue;
+			}
+			Bucket->NextIndex++;
+
+			const uint64 StartTime = FPlatformTime::Cycles64();
+			{
+				FScopeCycleCounter CycleCounter(Bucket->StatId);
+				Tickable->GameTick(DeltaTime);
+			}
+			const uint64 Cycles = FPlatformTime::Cycles64() - StartTime;
+			Spend(Category, Cycles);
+			ClassCosts.FindOrAdd(Class).Add(Cycles, FrameNumber, GetShareCycles(Category));
+		}
+	}
+
+	bRunningGameTick = !bDone;
+}
+
+void UTickManager::RunParallelGameTick()
+{
+	struct FParallelTick
+	{
+		const UClass* Class;
+
+		ETickCategory Category;
+
+		TScriptInterface<IGameTickable> Tickable;
+
+		int32 Wave;
+
+		uint64 TickCycles = 0;
+
+		uint64 MergeCycles = 0;
+	};
+
+	TArray<FParallelTick> Ticks;
+	TMap<FChunkPosition, int32> LastReadWave;
+	TMap<FChunkPosition, int32> LastWriteWave;
+	TArray<FChunkPosition> Reads;
+	TArray<FChunkPosition> Writes;
+	for (const UClass* Class : TickableClasses)
+	{
+		const FTickableBucket* Bucket = TickablesByClass.Find(Class);
+		if (!Bucket || !Bucket->bParallel)
 		{
-			const auto StartTime = FPlatformTime::Cycles();
-			const auto& TickableInterface = CurrentTickableList[j];
-			if (TickableInterface)
+			continue;
+		}
+
+		for (const TScriptInterface<IGameTickable>& Tickable : Bucket->Tickables)
+		{
+			if (!Tickable)
+			{
+				continue;
+			}
+
+			Reads.Reset();
+			Writes.Reset();
+			Tickable->GetTickChunkAccess(Reads, Writes);
+
+			int32 Wave = 0;
+			for (const FChunkPosition& Position : Reads)
 			{
-				TickableInterface->GameTick(DeltaTime);
-			} else
+				if (const int32* Last = LastWriteWave.Find(Position))
+				{
+					Wave = FMath::Max(Wave, *Last + 1);
+				}
+			}
+			for (const FChunkPosition& Position : Writes)
 			{
-				ToRemoveIdx.Add(j);
+				if (const int32* Last = LastWriteWave.Find(Position))
+				{
+					Wave = FMath::Max(Wave, *Last + 1);
+				}
+				if (const int32* Last = LastReadWave.Find(Position))
+				{
+					Wave = FMath::Max(Wave, *Last + 1);
+				}
 			}
-			const auto EndTime = FPlatformTime::Cycles();
-			CurrentBudget -= EndTime - StartTime;
 
-			// No budget and has more
-			if (CurrentBudget <= 0 && i < TickableClasses.Num() - 1 && j < Len - 1)
+			for (const FChunkPosition& Position : Reads)
 			{
-				return;
+				int32& Last = LastReadWave.FindOrAdd(Position, Wave);
+				Last = FMath::Max(Last, Wave);
 			}
+			for (const FChunkPosition& Position : Writes)
+			{
+				int32& Last = LastWriteWave.FindOrAdd(Position, Wave);
+				Last = FMath::Max(Last, Wave);
+			}
+
+			Ticks.Add(FParallelTick{Class, Bucket->Category, Tickable, Wave});
 		}
+	}
 
-		RemoveTickableByIndexes(ToRemoveIdx);
+	if (Ticks.IsEmpty())
+	{
+		return;
 	}
 
-	bRunningGameTick = false;
+	// Stable, registration order is kept within each wave
+	Ticks.StableSort([](const FParallelTick& A, const FParallelTick& B)
+	{
+		return A.Wave < B.Wave;
+	});
+
+	const float DeltaTime = GetWorld()->GetDeltaSeconds();
+	const EParallelForFlags Flags = GameConstants::Tick::bParallelGameTick ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread;
+	for (int32 WaveStart = 0; WaveStart < Ticks.Num();)
+	{
+		int32 WaveEnd = WaveStart + 1;
+		while (WaveEnd < Ticks.Num() && Ticks[WaveEnd].Wave == Ticks[WaveStart].Wave)
+		{
+			++WaveEnd;
+		}
+
+		const uint64 WaveStartTime = FPlatformTime::Cycles64();
+		ParallelFor(WaveEnd - WaveStart, [&Ticks, WaveStart, DeltaTime](const int32 Offset)
+		{
+			FParallelTick& Entry = Ticks[WaveStart + Offset];
+			const uint64 StartTime = FPlatformTime::Cycles64();
+			Entry.Tickable->ParallelGameTick(DeltaTime);
+			Entry.TickCycles = FPlatformTime::Cycles64() - StartTime;
+		}, Flags);
+		const uint64 WaveCycles = FPlatformTime::Cycles64() - WaveStartTime;
+
+		uint64 TotalTickCycles = 0;
+		for (int32 Index = WaveStart; Index < WaveEnd; ++Index)
+		{
+			TotalTickCycles += Ticks[Index].TickCycles;
+		}
+
+		for (int32 Index = WaveStart; Index < WaveEnd; ++Index)
+		{
+			FParallelTick& Entry = Ticks[Index];
+			const uint64 StartTime = FPlatformTime::Cycles64();
+			Entry.Tickable->MergeGameTick();
+			Entry.MergeCycles = FPlatformTime::Cycles64() - StartTime;
+
+			// The game thread waited the whole wave, each category pays for it as much as it kept the workers busy
+			const uint64 WaitCycles = TotalTickCycles > 0 ? WaveCycles * Entry.TickCycles / TotalTickCycles : 0;
+			Spend(Entry.Category, WaitCycles + Entry.MergeCycles);
+			ClassCosts.FindOrAdd(Entry.Class).Add(Entry.TickCycles + Entry.MergeCycles, FrameNumber, GetShareCycles(Entry.Category));
+		}
+
+		WaveStart = WaveEnd;
+	}
 }
 
 void UTickManager::OnWorldBeginTearDown(UWorld* World)
@@ -124,12 +286,10 @@ void UTickManager::OnWorldBeginTearDown(UWorld* World)
 	UE_LOG(LogTemp, Log, TEXT("UTickManager::OnWorldBeginTearDown called. Running scheduled functions and waiting for async ones."));
 	while (PendingTasks > 0)
 	{
-		while (!ScheduledFns.IsEmpty())
+		for (const TUniquePtr<FContinuationQueue>& Queue : ScheduledFns)
 		{
-			TFunction<void()> Func;
-			if (ScheduledFns.Dequeue(Func))
+			while (Queue->RunOne())
 			{
-				Func();
 			}
 		}
 
@@ -153,6 +313,14 @@ void UTickManager::RecalculateBudget()
 UTickManager* UTickManager::Init()
 {
 	RecalculateBudget();
+	for (uint8 Index = 0; Index < static_cast<uint8>(ETickCategory::Num); ++Index)
+	{
+		ScheduledFns[Index] = MakeUnique<FContinuationQueue>(GameConstants::Tick::ContinuationCapacity);
+#if STATS
+		ContinuationStatIds[Index] = FDynamicStats::CreateStatId<FStatGroup_STATGROUP_GameTick>(
+			FString::Printf(TEXT("Continuations %s"), LexToString(static_cast<ETickCategory>(Index))));
+#endif
+	}
 	FWorldDelegates::OnWorldBeginTearDown.AddUObject(this, &UTickManager::OnWorldBeginTearDown);
 	return this;
 }
@@ -170,11 +338,16 @@ void UTickManager::RegisterUObjectTickable(const TScriptInterface<IGameTickable>
 	if (!TickablesByClass.Contains(ClassKey))
 	{
 		TickableClasses.Add(ClassKey);
-		TickablesByClass.Add(ClassKey, {});
+		FTickableBucket& NewBucket = TickablesByClass.Add(ClassKey);
+		NewBucket.Category = TickableObject->GetTickCategory();
+		NewBucket.bParallel = TickableObject->IsParallelTickSafe();
+#if STATS
+		NewBucket.StatId = FDynamicStats::CreateStatId<FStatGroup_STATGROUP_GameTick>(ClassKey->GetName());
+#endif
 	}
 
 	const auto Bucket = TickablesByClass.Find(ClassKey);
-	Bucket->AddUnique(TickableObject);
+	Bucket->Tickables.AddUnique(TickableObject);
 }
 
 void UTickManager::UnregisterUObjectTickable(const TScriptInterface<IGameTickable>& TickableObject)
@@ -186,22 +359,141 @@ void UTickManager::UnregisterUObjectTickable(const TScriptInterface<IGameTickabl
 
 	const UObject* Obj = TickableObject.GetObject();
 	const UClass* ClassKey = Obj->GetClass();
-	if (TArray<TScriptInterface<IGameTickable>>* Bucket = TickablesByClass.Find(ClassKey))
+	if (FTickableBucket* Bucket = TickablesByClass.Find(ClassKey))
 	{
-		Bucket->Remove(TickableObject);
-		if (Bucket->Num() == 0)
+		const int32 Index = Bucket->Tickables.IndexOfByKey(TickableObject);
+		if (Index == INDEX_NONE)
+		{
+			return;
+		}
+
+		// Keeps the game tick in progress from skipping the one after it
+		Bucket->Tickables.RemoveAt(Index);
+		if (Index < Bucket->NextIndex)
+		{
+			Bucket->NextIndex--;
+		}
+
+		if (Bucket->Tickables.Num() == 0)
 		{
 			TickablesByClass.Remove(ClassKey);
+			TickableClasses.Remove(ClassKey);
 		}
 	}
 }
 
-void UTickManager::Th_ScheduleFn(TFunction<void()>&& Func)
+void UTickManager::LogCosts() const
 {
-	ScheduledFns.Enqueue(MoveTemp(Func));
+	UE_LOG(LogTemp, Display, TEXT("Tick costs, budget %.3f ms per frame over %llu frames"),
+		FPlatformTime::ToMilliseconds64(CalculatedTickBudget), FrameNumber);
+
+	auto LogCost = [this](const FString& Name, const ETickCategory Category, const FTickCost& Cost)
+	{
+		UE_LOG(LogTemp, Display, TEXT("  %-40s %-14s share %3.0f%%  %8llu calls  total %9.2f ms  p50 <%7.0f us  p99 <%7.0f us  %6u frames over share"),
+			*Name, LexToString(Category), TickCategoryUtils::GetShare(Category) * 100.f, Cost.Count, Cost.Total / 1000.0,
+			Cost.GetPercentile(0.5), Cost.GetPercentile(0.99), Cost.OverBudgetFrames);
+	};
+
+	for (const auto& [Class, Cost] : ClassCosts)
+	{
+		const FTickableBucket* Bucket = TickablesByClass.Find(Class);
+		LogCost(Class->GetName(), Bucket ? Bucket->Category : ETickCategory::Default, Cost);
+	}
+
+	for (uint8 Index = 0; Index < static_cast<uint8>(ETickCategory::Num); ++Index)
+	{
+		const ETickCategory Category = static_cast<ETickCategory>(Index);
+		LogCost(FString::Printf(TEXT("Continuations %s"), LexToString(Category)), Category, ContinuationCosts[Index]);
+	}
+}
+
+bool UTickManager::WriteCostsCsv(const FString& Path) const
+{
+	FString Csv = TEXT("Name,Category,Share,Count,TotalMs,P50Us,P99Us,MaxUs,OverBudgetFrames") + FTickCost::GetCsvHeader(TEXT("us"));
+	Csv += LINE_TERMINATOR;
+
+	auto AddRow = [&Csv](const FString& Name, const ETickCategory Category, const FTickCost& Cost)
+	{
+		Csv += FString::Printf(TEXT("%s,%s,%.3f,%llu,%.3f,%.0f,%.0f,%.1f,%u"), *Name, LexToString(Category),
+			TickCategoryUtils::GetShare(Category), Cost.Count, Cost.Total / 1000.0, Cost.GetPercentile(0.5),
+			Cost.GetPercentile(0.99), Cost.Max, Cost.OverBudgetFrames);
+		Cost.AppendCsvBuckets(Csv);
+		Csv += LINE_TERMINATOR;
+	};
+
+	for (const auto& [Class, Cost] : ClassCosts)
+	{
+		const FTickableBucket* Bucket = TickablesByClass.Find(Class);
+		AddRow(Class->GetName(), Bucket ? Bucket->Category : ETickCategory::Default, Cost);
+	}
+
+	for (uint8 Index = 0; Index < static_cast<uint8>(ETickCategory::Num); ++Index)
+	{
+		const ETickCategory Category = static_cast<ETickCategory>(Index);
+		AddRow(FString::Printf(TEXT("Continuations %s"), LexToString(Category)), Category, ContinuationCosts[Index]);
+	}
+
+	return FFileHelper::SaveStringToFile(Csv, *Path);
+}
+
+void UTickManager::ResetCosts()
+{
+	ClassCosts.Reset();
+	for (FTickCost& Cost : ContinuationCosts)
+	{
+		Cost = FTickCost();
+	}
 }
 
 ETickableTickType UTickManager::GetTickableTickType() const
 {
 	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Always;
-}
\ No newline at end of file
+}
+
+static UTickManager* FindTickManager(UWorld* World)
+{
+	const AGameManager* GameManager = Cast<AGameManager>(UGameplayStatics::GetActorOfClass(World, AGameManager::StaticClass()));
+	return GameManager ? GameManager->TickManager : nullptr;
+}
+
+static FAutoConsoleCommand CmdTickCosts(
+	TEXT("game.ticks.stats"),
+	TEXT("Logs the cycles spent by each game tickable class and continuation category, and how often they went over their budget share. Pass reset to start over"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UTickManager* TickManager = FindTickManager(World);
+		if (!TickManager)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("No world is loaded"));
+			return;
+		}
+
+		TickManager->LogCosts();
+		if (Args.Num() > 0 && Args[0] == TEXT("reset"))
+		{
+			TickManager->ResetCosts();
+		}
+	}));
+
+static FAutoConsoleCommand CmdTickCostsCsv(
+	TEXT("game.ticks.csv"),
+	TEXT("Writes the tick costs of each game tickable class and continuation category to a CSV file, Saved/Profiling/TickCosts.csv by default"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const UTickManager* TickManager = FindTickManager(World);
+		if (!TickManager)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("No world is loaded"));
+			return;
+		}
+
+		const FString Path = Args.Num() > 0 ? Args[0] : FPaths::ProfilingDir() / TEXT("TickCosts.csv");
+		if (TickManager->WriteCostsCsv(Path))
+		{
+			UE_LOG(LogTemp, Display, TEXT("Tick costs written to %s"), *Path);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Failed to write the tick costs to %s"), *Path);
+		}
+	}));
@@ -3,10 +3,28 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "ContinuationQueue.h"
 #include "GameTickable.h"
+#include "JobSystem.h"
+#include "TickCost.h"
 #include "UObject/Object.h"
 #include "TickManager.generated.h"
 
+struct FTickableBucket
+{
+	TArray<TScriptInterface<IGameTickable>> Tickables;
+
+	// Next one to tick in the current game tick, Num once all were
+	int32 NextIndex = 0;
+
+	ETickCategory Category = ETickCategory::Default;
+
+	// Ticked by RunParallelGameTick, skipped by GameTick
+	bool bParallel = false;
+
+	TStatId StatId;
+};
+
 /**
  * 
  */
@@ -26,28 +44,42 @@ class BLUEVOX_API UTickManager : public UObject, public FTickableGameObject
 
 	UPROPERTY()
 	int32 LastGameTickTime = 0;
-
-	UPROPERTY()
-	int32 CurrentTickableClassIndex = -1;
-
-	UPROPERTY()
-	int32 CurrentTickableIndex = 0;
 	
 	UPROPERTY()
 	bool bRunningGameTick = false;
 
+	// Cycles each category spent this frame, up to its share of the budget it goes before the others
+	TStaticArray<int64, static_cast<uint8>(ETickCategory::Num)> CategorySpent;
+
+	uint64 FrameNumber = 0;
+
 	UPROPERTY()
 	int32 PendingTasks = 0;
 
 	UPROPERTY()
 	TArray<const UClass*> TickableClasses;
 	
-	TMap<const UClass*, TArray<TScriptInterface<IGameTickable>>> TickablesByClass;
+	TMap<const UClass*, FTickableBucket> TickablesByClass;
 
-	TQueue<TFunction<void()>, EQueueMode::Mpsc> ScheduledFns;
+	// One per category, created in Init and sized by game.ticks.continuation_capacity
+	TStaticArray<TUniquePtr<FContinuationQueue>, static_cast<uint8>(ETickCategory::Num)> ScheduledFns;
 
-	UFUNCTION()
-	void RemoveTickableByIndexes(TArray<int32>& Indexes);
+	// Kept after the class has no tickable left, so the stats cover the whole session
+	TMap<const UClass*, FTickCost> ClassCosts;
+
+	TStaticArray<FTickCost, static_cast<uint8>(ETickCategory::Num)> ContinuationCosts;
+
+	TStaticArray<TStatId, static_cast<uint8>(ETickCategory::Num)> ContinuationStatIds;
+
+	// Within its share of the budget, or any budget is left and bLeftover
+	bool CanSpend(const ETickCategory Category, const bool bLeftover) const;
+
+	void Spend(const ETickCategory Category, const int64 Cycles);
+
+	int64 GetShareCycles(const ETickCategory Category) const;
+
+	// Round robin over the categories until they are empty or out of budget
+	void RunScheduledFns(const bool bLeftover);
 	
 	virtual void Tick(float DeltaTime) override;
 
@@ -56,8 +88,15 @@ class BLUEVOX_API UTickManager : public UObject, public FTickableGameObject
 	UFUNCTION()
 	void PrepareForGameTick();
 
-	UFUNCTION()
-	void GameTick();
+	// Classes out of their share are skipped, the game tick goes on with them the next frame
+	void GameTick(const bool bLeftover);
+
+	/**
+	 * Ticks the parallel tickables in waves, each after all those registered before it that write what it touches or
+	 * read what it writes. Every wave merges in registration order before the next starts, so the result is the one
+	 * of ticking them serially whatever the number of workers.
+	 */
+	void RunParallelGameTick();
 
 	UFUNCTION()
 	void OnWorldBeginTearDown(UWorld* World);
@@ -71,29 +110,51 @@ public:
 
 	void UnregisterUObjectTickable(const TScriptInterface<IGameTickable>& TickableObject);
 
+	/**
+	 * Runs AsyncFn as a job on Lane, then ThenFn with its result on the game thread, accounted to Category. When Token
+	 * is cancelled before the job starts AsyncFn is skipped and ThenFn gets a default constructed result, check the
+	 * token there.
+	 */
 	template<typename AsyncFunc, typename ThenFunc>
-	void RunAsyncThen(AsyncFunc&& AsyncFn, ThenFunc&& ThenFn);
+	void RunJobThen(const EJobLane Lane, const ETickCategory Category, const FJobCancellationToken& Token,
+		AsyncFunc&& AsyncFn, ThenFunc&& ThenFn);
+
+	// Runs Func on the game thread within the budget share of Category. Moved into a pooled record, nothing is
+	// allocated or copied
+	template<typename FuncType>
+	void Th_ScheduleFn(const ETickCategory Category, FuncType&& Func)
+	{
+		ScheduledFns[static_cast<uint8>(Category)]->Enqueue(Forward<FuncType>(Func));
+	}
+
+	void LogCosts() const;
 
-	void Th_ScheduleFn(TFunction<void()>&& Func);
+	// A row per tickable class and continuation category
+	bool WriteCostsCsv(const FString& Path) const;
+
+	void ResetCosts();
 
 	virtual ETickableTickType GetTickableTickType() const override;
 };
 
 template<class A, class T>
-void UTickManager::RunAsyncThen(A&& AsyncFn, T&& ThenFn)
+void UTickManager::RunJobThen(const EJobLane Lane, const ETickCategory Category, const FJobCancellationToken& Token,
+	A&& AsyncFn, T&& ThenFn)
 {
 	PendingTasks++;
 
 	using R = std::invoke_result_t<A>;
-	auto Fut = Async(EAsyncExecution::ThreadPool,
-					 std::forward<A>(AsyncFn));
-
-	Fut.Then([this, thenFn = std::forward<T>(ThenFn)]
-			 (TFuture<R>&& Future) mutable
+	FJobSystem::Get().Launch(Lane, Token,
+		[this, Category, asyncFn = std::forward<A>(AsyncFn), thenFn = std::forward<T>(ThenFn)]
+		(const bool bCancelled) mutable
 	{
 		if constexpr (std::is_void_v<R>)
 		{
-			Th_ScheduleFn([=, this]() mutable
+			if (!bCancelled)
+			{
+				asyncFn();
+			}
+			Th_ScheduleFn(Category, [this, thenFn = MoveTemp(thenFn)]() mutable
 			{
 				thenFn();
 				--PendingTasks;
@@ -101,10 +162,10 @@ void UTickManager::RunAsyncThen(A&& AsyncFn, T&& ThenFn)
 		}
 		else
 		{
-			R Result = Future.Get();
-			Th_ScheduleFn([=, this, res = std::move(Result)]() mutable
+			R Result = bCancelled ? R() : asyncFn();
+			Th_ScheduleFn(Category, [this, thenFn = MoveTemp(thenFn), res = MoveTemp(Result)]() mutable
 			{
-				thenFn(std::move(res));
+				thenFn(MoveTemp(res));
 				--PendingTasks;
 			});
 		}
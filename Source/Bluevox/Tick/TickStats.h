@@ -0,0 +1,2 @@
+﻿#pragma once
+DECLARE_STATS_GROUP(TEXT("GameTick"), STATGROUP_GameTick, STATCAT_Advanced);
@@ -0,0 +1,85 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Latencies in power of two buckets of a unit picked by the caller (ms, us...): the first is below 1, bucket N below
+ * 2^N and the last has no upper bound.
+ */
+template <int32 InNumBuckets>
+struct TLatencyHistogram
+{
+	static constexpr int32 NumBuckets = InNumBuckets;
+
+	uint64 Buckets[NumBuckets] = {};
+
+	uint64 Count = 0;
+
+	double Total = 0;
+
+	double Max = 0;
+
+	void Add(const double Value)
+	{
+		const int32 Bucket = Value < 1.0 ? 0 : FMath::Min(FMath::FloorLog2(static_cast<uint32>(FMath::Min(Value, 4e9))) + 1, NumBuckets - 1);
+		Buckets[Bucket]++;
+		Count++;
+		Total += Value;
+		Max = FMath::Max(Max, Value);
+	}
+
+	double GetAverage() const
+	{
+		return Count > 0 ? Total / Count : 0.0;
+	}
+
+	// Upper bound of the bucket Percentile (0 to 1) falls in
+	double GetPercentile(const double Percentile) const
+	{
+		if (Count == 0)
+		{
+			return 0;
+		}
+
+		const uint64 Target = FMath::Max<uint64>(FMath::CeilToInt64(Count * Percentile), 1);
+		uint64 Seen = 0;
+		for (int32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+		{
+			Seen += Buckets[Bucket];
+			if (Seen >= Target)
+			{
+				// The last bucket has no upper bound, the slowest one seen is the closest to it
+				return Bucket == NumBuckets - 1 ? Max : GetBucketUpper(Bucket);
+			}
+		}
+
+		return Max;
+	}
+
+	static double GetBucketUpper(const int32 Bucket)
+	{
+		return static_cast<double>(1u << Bucket);
+	}
+
+	// One column per bucket, e.g. ",<1ms,<2ms,...,32768ms+"
+	static FString GetCsvHeader(const TCHAR* Unit)
+	{
+		FString Header;
+		for (int32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+		{
+			Header += Bucket == NumBuckets - 1
+				? FString::Printf(TEXT(",%.0f%s+"), GetBucketUpper(Bucket - 1), Unit)
+				: FString::Printf(TEXT(",<%.0f%s"), GetBucketUpper(Bucket), Unit);
+		}
+		return Header;
+	}
+
+	// The counts under GetCsvHeader
+	void AppendCsvBuckets(FString& Csv) const
+	{
+		for (const uint64 BucketCount : Buckets)
+		{
+			Csv += FString::Printf(TEXT(",%llu"), BucketCount);
+		}
+	}
+};